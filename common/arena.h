@@ -0,0 +1,111 @@
+#pragma once
+
+// Per-turn scratch memory without heap traffic
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Fixed-size view over memory owned by somebody else, e.g. by ScratchArena
+template <typename T>
+class ArenaArray {
+public:
+    ArenaArray(T* data, size_t capacity, size_t size)
+        : Data(data)
+        , Capacity(capacity)
+        , Size(size)
+    {
+    }
+
+    T& operator[](size_t index) {
+        return Data[index];
+    }
+
+    const T& operator[](size_t index) const {
+        return Data[index];
+    }
+
+    T* begin() {
+        return Data;
+    }
+
+    T* end() {
+        return Data + Size;
+    }
+
+    const T* begin() const {
+        return Data;
+    }
+
+    const T* end() const {
+        return Data + Size;
+    }
+
+    size_t size() const {
+        return Size;
+    }
+
+    bool empty() const {
+        return Size == 0;
+    }
+
+    const T& front() const {
+        return Data[0];
+    }
+
+    void PushBack(const T& value) {
+        if (Size == Capacity) {
+            throw std::runtime_error("ArenaArray is full");
+        }
+        Data[Size++] = value;
+    }
+
+private:
+    T* Data;
+    size_t Capacity;
+    size_t Size;
+};
+
+// Bump allocator which is sized once and then reused: everything allocated during a turn
+// is released together by Reset(), so no heap traffic happens in the steady state.
+class ScratchArena {
+public:
+    explicit ScratchArena(size_t capacity)
+        : Buffer(capacity)
+    {
+    }
+
+    template <typename T>
+    ArenaArray<T> Allocate(size_t capacity, size_t size = 0) {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+            "ScratchArena never runs destructors");
+
+        const size_t offset = AlignUp(Used, alignof(T));
+        const size_t bytes = capacity * sizeof(T);
+        if (offset + bytes > Buffer.size()) {
+            throw std::runtime_error("ScratchArena is exhausted");
+        }
+        Used = offset + bytes;
+        return {reinterpret_cast<T*>(Buffer.data() + offset), capacity, size};
+    }
+
+    void Reset() {
+        Used = 0;
+    }
+
+    // How many bytes are needed to allocate the given number of T, whatever the arena state is
+    template <typename T>
+    static constexpr size_t Footprint(size_t count) {
+        return count * sizeof(T) + alignof(T) - 1;
+    }
+
+private:
+    std::vector<unsigned char> Buffer;
+    size_t Used = 0;
+
+private:
+    static constexpr size_t AlignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+};
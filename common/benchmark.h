@@ -0,0 +1,371 @@
+#pragma once
+
+// Shared helpers for the offline benchmarks: they are never a part of a submission
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <ostream>
+#include <random>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+#include "input_reader.h"
+#include "output_writer.h"
+#include "trace.h"
+
+// Collects per-turn latencies and game outcomes over a series of simulated games
+class BenchmarkStats {
+public:
+    using Duration = std::chrono::nanoseconds;
+
+public:
+    void AddTurn(Duration latency) {
+        Latencies.push_back(latency);
+        TotalTime += latency;
+    }
+
+    void AddGame(bool isWon) {
+        ++Games;
+        if (isWon) {
+            ++Wins;
+        }
+    }
+
+    size_t GetGames() const {
+        return Games;
+    }
+
+    size_t GetWins() const {
+        return Wins;
+    }
+
+    size_t GetTurns() const {
+        return Latencies.size();
+    }
+
+    void Merge(const BenchmarkStats& other) {
+        Latencies.insert(Latencies.end(), other.Latencies.begin(), other.Latencies.end());
+        TotalTime += other.TotalTime;
+        Games += other.Games;
+        Wins += other.Wins;
+    }
+
+    // Wall-clock time of the whole run, for the throughput of games played concurrently
+    void SetWallTime(Duration wallTime) {
+        WallTime = wallTime;
+    }
+
+    void Report(std::ostream& os, const std::string& name) {
+        std::sort(Latencies.begin(), Latencies.end());
+        const double seconds = std::chrono::duration<double>(TotalTime).count();
+
+        os << std::fixed << std::setprecision(2)
+            << name << ": games " << Games
+            << ", win rate " << (Games == 0 ? 0.0 : 100.0 * static_cast<double>(Wins) / static_cast<double>(Games)) << "%"
+            << ", turns " << Latencies.size()
+            << ", turns/sec " << (seconds > 0 ? static_cast<double>(Latencies.size()) / seconds : 0.0)
+            << ", latency us p50 " << PercentileMicros(0.50)
+            << " p90 " << PercentileMicros(0.90)
+            << " p99 " << PercentileMicros(0.99)
+            << " max " << PercentileMicros(1.0);
+        if (WallTime > Duration::zero()) {
+            os << ", games/sec " << static_cast<double>(Games) / std::chrono::duration<double>(WallTime).count();
+        }
+        os << '\n';
+    }
+
+private:
+    std::vector<Duration> Latencies;
+    Duration TotalTime = Duration::zero();
+    Duration WallTime = Duration::zero();
+    size_t Games = 0;
+    size_t Wins = 0;
+
+private:
+    // Latencies must be sorted already
+    double PercentileMicros(double fraction) const {
+        if (Latencies.empty()) {
+            return 0.0;
+        }
+        const auto index = static_cast<size_t>(fraction * static_cast<double>(Latencies.size() - 1));
+        return std::chrono::duration<double, std::micro>(Latencies[index]).count();
+    }
+};
+
+// Measures a single call, e.g. one turn of a solution
+template <typename FunctionType>
+BenchmarkStats::Duration MeasureCall(const FunctionType& function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration_cast<BenchmarkStats::Duration>(std::chrono::steady_clock::now() - start);
+}
+
+// Positional command line argument with a fallback: `benchmark.bin [games] [seed]`
+inline uint64_t GetArgument(int argc, const char** argv, int index, uint64_t defaultValue) {
+    return index < argc ? std::strtoull(argv[index], nullptr, 10) : defaultValue;
+}
+
+// Random generator of a single game: it depends only on the seed and the game's index, so the games
+// are the same however they are spread over threads
+inline std::mt19937 MakeGameRandom(uint64_t seed, uint64_t game) {
+    std::seed_seq sequence{
+        static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32),
+        static_cast<uint32_t>(game), static_cast<uint32_t>(game >> 32)};
+    return std::mt19937(sequence);
+}
+
+// Plays games [0, games) on a few threads, each taking the next unplayed game once it's done with
+// its previous one, and merges what they measured. playGame(game, stats) returns whether it's won.
+template <typename PlayGameType>
+BenchmarkStats RunGames(uint64_t games, size_t threadsCount, const PlayGameType& playGame) {
+    std::atomic<uint64_t> nextGame{0};
+    std::vector<BenchmarkStats> shards(std::max<size_t>(threadsCount, 1));
+    const auto work = [&](BenchmarkStats& stats) {
+        for (uint64_t game = nextGame++; game < games; game = nextGame++) {
+            stats.AddGame(playGame(game, stats));
+        }
+    };
+
+    BenchmarkStats result;
+    result.SetWallTime(MeasureCall([&] {
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < shards.size(); ++i) {
+            threads.emplace_back(work, std::ref(shards[i]));
+        }
+        work(shards[0]);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }));
+    for (const auto& shard : shards) {
+        result.Merge(shard);
+    }
+    return result;
+}
+
+// In-memory pipe between a referee and a solution in the same thread: whatever is written is read
+// back in order. The buffer is reused once everything in it has been read, so unlike
+// std::stringstream it doesn't allocate as long as the text of a turn fits into it.
+class MemoryChannel final : public std::streambuf {
+public:
+    MemoryChannel() {
+        Data.reserve(INITIAL_CAPACITY);
+    }
+
+protected:
+    int_type underflow() override {
+        return gptr() < egptr() ? traits_type::to_int_type(*gptr()) : traits_type::eof();
+    }
+
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            const char data = traits_type::to_char_type(c);
+            Append(&data, 1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize length) override {
+        Append(data, static_cast<size_t>(length));
+        return length;
+    }
+
+private:
+    static constexpr size_t INITIAL_CAPACITY = 4096;
+
+    std::vector<char> Data;
+
+private:
+    void Append(const char* data, size_t length) {
+        size_t readPosition = eback() == nullptr ? 0 : static_cast<size_t>(gptr() - eback());
+        if (readPosition == Data.size()) {
+            Data.clear();
+            readPosition = 0;
+        }
+        Data.insert(Data.end(), data, data + length);
+        setg(Data.data(), Data.data() + readPosition, Data.data() + Data.size());
+    }
+};
+
+// A whole file in memory, read-only: mapped where mmap exists, read into a buffer elsewhere
+class MappedFile {
+public:
+    explicit MappedFile(const char* path) {
+        #ifdef HAS_MMAP
+        const int descriptor = open(path, O_RDONLY);
+        struct stat status;
+        if (descriptor < 0 || fstat(descriptor, &status) != 0) {
+            throw std::runtime_error("Can't open the file to map");
+        }
+        Size = static_cast<size_t>(status.st_size);
+        if (Size != 0) {
+            void* mapping = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if (mapping == MAP_FAILED) {
+                close(descriptor);
+                throw std::runtime_error("Can't map the file");
+            }
+            Data = static_cast<const uint8_t*>(mapping);
+        }
+        close(descriptor);
+        #else
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Can't open the file to map");
+        }
+        Buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        Data = reinterpret_cast<const uint8_t*>(Buffer.data());
+        Size = Buffer.size();
+        #endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        #ifdef HAS_MMAP
+        if (Data != nullptr) {
+            munmap(const_cast<uint8_t*>(Data), Size);
+        }
+        #endif
+    }
+
+    const uint8_t* GetData() const {
+        return Data;
+    }
+
+    size_t GetSize() const {
+        return Size;
+    }
+
+private:
+    const uint8_t* Data = nullptr;
+    size_t Size = 0;
+    #ifndef HAS_MMAP
+    std::vector<char> Buffer;
+    #endif
+};
+
+// Plays a recorded game back through a solution: the input of every turn comes from the trace
+// and the command the solution answers with is compared with the recorded one
+class TraceReplayer {
+public:
+    TraceReplayer(const uint8_t* data, size_t size)
+        : Trace(data, size)
+        , Input(&ToSolution)
+        , Output(&ToReferee)
+        , Reader(Input)
+        , Writer(Output)
+    {
+    }
+
+    InputReader& GetInput() {
+        return Reader;
+    }
+
+    OutputWriter& GetOutput() {
+        return Writer;
+    }
+
+    size_t GetTurns() const {
+        return Turns;
+    }
+
+    size_t GetMismatches() const {
+        return Mismatches;
+    }
+
+    // Feeds the input up to the next recorded command; false when there is none, i.e. the game is over
+    bool FeedTurn() {
+        while (!Trace.IsOver()) {
+            const auto record = Trace.Next();
+            if (record.Kind == TraceRecordKind::OUTPUT) {
+                Expected.assign(reinterpret_cast<const char*>(record.Data), record.Size);
+                return true;
+            }
+            TraceReader::DecodeInputLine(record, Line);
+            Input << Line;
+        }
+        return false;
+    }
+
+    // Compares what the solution has written since FeedTurn with the recorded command
+    bool CheckCommand(std::ostream& log) {
+        std::getline(Output, Line);
+        ++Turns;
+        if (Line == Expected) {
+            return true;
+        }
+        ++Mismatches;
+        log << "turn " << Turns << ": recorded \"" << Expected << "\", replayed \"" << Line << "\"\n";
+        return false;
+    }
+
+private:
+    TraceReader Trace;
+    MemoryChannel ToSolution;
+    MemoryChannel ToReferee;
+    std::iostream Input;
+    std::iostream Output;
+    InputReader Reader;
+    OutputWriter Writer;
+    std::string Expected;
+    std::string Line;
+    size_t Turns = 0;
+    size_t Mismatches = 0;
+};
+
+// `replay.bin <trace file> [repeats]`: replays the trace a few times, reports the latencies as the
+// benchmarks do (a repeat is "won" when it matches the recording) and prints every command which
+// differs from the recorded one, once.
+// makeSolution(input) builds a solution out of the initial input, step(solution, input, output) plays a turn.
+template <typename MakeSolutionType, typename StepType>
+int RunReplay(int argc, const char** argv, const std::string& name, const MakeSolutionType& makeSolution, const StepType& step) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <trace file> [repeats]\n";
+        return 2;
+    }
+    const MappedFile trace(argv[1]);
+    const auto repeats = GetArgument(argc, argv, 2, 1);
+
+    BenchmarkStats stats;
+    size_t mismatches = 0;
+    std::ostream nowhere(nullptr);
+    for (uint64_t repeat = 0; repeat < repeats; ++repeat) {
+        TraceReplayer replayer(trace.GetData(), trace.GetSize());
+        auto& log = repeat == 0 ? std::cout : nowhere;
+        if (replayer.FeedTurn()) {
+            auto solution = makeSolution(replayer.GetInput());
+            do {
+                stats.AddTurn(MeasureCall([&] {
+                    step(solution, replayer.GetInput(), replayer.GetOutput());
+                }));
+                replayer.CheckCommand(log);
+            } while (replayer.FeedTurn());
+        }
+        mismatches = repeat == 0 ? replayer.GetMismatches() : mismatches;
+        stats.AddGame(replayer.GetMismatches() == 0);
+    }
+    stats.Report(std::cout, name + " replay");
+    std::cout << "mismatches " << mismatches << '\n';
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+// Grids of flags packed into a machine word per row
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+// Bit-packed grid: every row is a single machine word, so the board can't be wider than 64 cells.
+// The rows live inline, as many as MAX_ROWS_COUNT: a board sized for the puzzle takes a few cache lines.
+template <size_t MAX_ROWS_COUNT>
+class BasicBitBoard {
+public:
+    using RowType = uint64_t;
+
+    static constexpr size_t MAX_COLUMNS = 64;
+    static constexpr size_t MAX_ROWS = MAX_ROWS_COUNT;
+
+public:
+    BasicBitBoard(size_t columns, size_t rows)
+        : Columns(columns)
+        , RowsCount(rows)
+    {
+        if (Columns > MAX_COLUMNS || RowsCount > MAX_ROWS) {
+            throw std::runtime_error("The board is too large for BasicBitBoard");
+        }
+    }
+
+    bool Get(size_t column, size_t row) const {
+        return (Rows[row] >> column) & 1u;
+    }
+
+    void Set(size_t column, size_t row) {
+        Rows[row] |= RowType{1} << column;
+    }
+
+    void Reset(size_t column, size_t row) {
+        Rows[row] &= ~(RowType{1} << column);
+    }
+
+    bool IsEmpty() const {
+        for (size_t row = 0; row < RowsCount; ++row) {
+            if (Rows[row] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t Count() const {
+        size_t result = 0;
+        for (size_t row = 0; row < RowsCount; ++row) {
+            result += static_cast<size_t>(__builtin_popcountll(Rows[row]));
+        }
+        return result;
+    }
+
+    void Clear() {
+        std::fill(Rows.begin(), Rows.begin() + RowsCount, RowType{0});
+    }
+
+    bool operator==(const BasicBitBoard& other) const {
+        return Columns == other.Columns && RowsCount == other.RowsCount
+            && std::equal(Rows.begin(), Rows.begin() + RowsCount, other.Rows.begin());
+    }
+
+    bool operator!=(const BasicBitBoard& other) const {
+        return !(*this == other);
+    }
+
+    BasicBitBoard& operator|=(const BasicBitBoard& other) {
+        for (size_t row = 0; row < RowsCount; ++row) {
+            Rows[row] |= other.Rows[row];
+        }
+        return *this;
+    }
+
+    // Cells which are set here but not in the other board
+    BasicBitBoard Without(const BasicBitBoard& other) const {
+        BasicBitBoard result(Columns, RowsCount);
+        for (size_t row = 0; row < RowsCount; ++row) {
+            result.Rows[row] = Rows[row] & ~other.Rows[row];
+        }
+        return result;
+    }
+
+    // Every set cell spreads to its 8 neighbours: that is exactly one step of the flood fill
+    BasicBitBoard Dilated() const {
+        const RowType columnsMask = AllOnes(static_cast<int>(Columns));
+        std::array<RowType, MAX_ROWS> horizontal;
+        for (size_t row = 0; row < RowsCount; ++row) {
+            horizontal[row] = (Rows[row] | (Rows[row] << 1) | (Rows[row] >> 1)) & columnsMask;
+        }
+
+        BasicBitBoard result(Columns, RowsCount);
+        for (size_t row = 0; row < RowsCount; ++row) {
+            RowType dilatedRow = horizontal[row];
+            if (row > 0) {
+                dilatedRow |= horizontal[row - 1];
+            }
+            if (row + 1 < RowsCount) {
+                dilatedRow |= horizontal[row + 1];
+            }
+            result.Rows[row] = dilatedRow;
+        }
+        return result;
+    }
+
+    template <typename FunctionType>
+    void ForEachSet(const FunctionType& function) const {
+        for (size_t row = 0; row < RowsCount; ++row) {
+            for (RowType bits = Rows[row]; bits != 0; bits &= bits - 1) {
+                function(static_cast<size_t>(__builtin_ctzll(bits)), row);
+            }
+        }
+    }
+
+    // Sets every cell within the Chebyshev radius of the given cell, clipped to the board
+    void SetSquare(int column, int row, int radius) {
+        const int firstColumn = std::max(column - radius, 0);
+        const int lastColumn = std::min(column + radius, static_cast<int>(Columns) - 1);
+        const int firstRow = std::max(row - radius, 0);
+        const int lastRow = std::min(row + radius, static_cast<int>(RowsCount) - 1);
+        if (firstColumn > lastColumn) {
+            return;
+        }
+
+        const RowType mask = (AllOnes(lastColumn - firstColumn + 1)) << firstColumn;
+        for (int y = firstRow; y <= lastRow; ++y) {
+            Rows[y] |= mask;
+        }
+    }
+
+private:
+    size_t Columns;
+    size_t RowsCount;
+    std::array<RowType, MAX_ROWS> Rows = {};
+
+private:
+    static RowType AllOnes(int bits) {
+        return bits >= static_cast<int>(MAX_COLUMNS) ? ~RowType{0} : (RowType{1} << bits) - 1;
+    }
+};
+
+using BitBoard = BasicBitBoard<64>;
@@ -0,0 +1,20 @@
+#pragma once
+
+// Validation of the referee's input values
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+template <typename T, typename PredicateType>
+T CheckArgument(const T& argument, const PredicateType& pred, const std::string& message = "") {
+    if (!pred(argument)) {
+        std::stringstream formattedMessage;
+        if (!message.empty()) {
+            formattedMessage << message << ": ";
+        }
+        formattedMessage << "argument '" << argument << "' is incorrect";
+        throw std::runtime_error(formattedMessage.str());
+    }
+    return argument;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Per-turn time limits on the monotonic clock
+
+#include <chrono>
+
+// The moment a turn has to be answered by. Checking it is a single clock read, and none at all
+// for an unlimited one, so searches can afford to look at it every hundred or so nodes.
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+public:
+    // A zero budget means no limit, e.g. for reproducible offline runs
+    static Deadline After(Clock::time_point start, std::chrono::milliseconds budget) {
+        return budget.count() > 0 ? Deadline(start + budget) : Never();
+    }
+
+    static Deadline Never() {
+        return Deadline(Clock::time_point::max());
+    }
+
+    bool IsUnlimited() const {
+        return At == Clock::time_point::max();
+    }
+
+    bool IsExpired() const {
+        return !IsUnlimited() && Clock::now() >= At;
+    }
+
+private:
+    Clock::time_point At;
+
+private:
+    explicit Deadline(Clock::time_point at)
+        : At(at)
+    {
+    }
+};
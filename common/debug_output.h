@@ -0,0 +1,63 @@
+#pragma once
+
+// Deferred stderr tracing which never delays an answer
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+
+// Debug text is kept in memory while a turn is computed and written out only after the answer is sent,
+// so stderr never delays the referee. When the buffer is full the oldest text is overwritten.
+class DebugRingBuffer final : public std::streambuf {
+public:
+    void DrainTo(std::ostream& output) {
+        const size_t start = (Head + CAPACITY - Size) % CAPACITY;
+        const size_t firstChunk = std::min(Size, CAPACITY - start);
+        output.write(Data.data() + start, static_cast<std::streamsize>(firstChunk));
+        output.write(Data.data(), static_cast<std::streamsize>(Size - firstChunk));
+        output.flush();
+        Size = 0;
+    }
+
+protected:
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            Put(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize length) override {
+        for (std::streamsize i = 0; i < length; ++i) {
+            Put(data[i]);
+        }
+        return length;
+    }
+
+private:
+    static constexpr size_t CAPACITY = 16 * 1024;
+
+    std::array<char, CAPACITY> Data;
+    size_t Head = 0;
+    size_t Size = 0;
+
+private:
+    void Put(char c) {
+        Data[Head] = c;
+        Head = (Head + 1) % CAPACITY;
+        Size = std::min(Size + 1, CAPACITY);
+    }
+};
+
+// Per thread, for the games an offline batch plays concurrently
+inline DebugRingBuffer& GetDebugBuffer() {
+    static thread_local DebugRingBuffer buffer;
+    return buffer;
+}
+
+inline std::ostream& DebugOutput() {
+    static thread_local std::ostream output(&GetDebugBuffer());
+    return output;
+}
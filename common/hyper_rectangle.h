@@ -0,0 +1,83 @@
+#pragma once
+
+// Box of candidate points for the searches which halve it on every probe
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+// Box of candidate points in any number of dimensions, [Low, High] along every axis. The cuts keep
+// the candidates on one side of a bound along an axis; an empty box is left for the caller to handle.
+// The middle is computed without overflows as long as the coordinates are non-negative, which is
+// all the puzzles use: High - Low may not fit into CoordinateType when Low is negative.
+template <typename CoordinateType, size_t DIMENSIONS>
+class HyperRectangle {
+public:
+    using PointType = std::array<CoordinateType, DIMENSIONS>;
+    // Per axis: -1 - the target is before the probe, 1 - after it, 0 - on the same hyperplane
+    using StepType = std::array<int, DIMENSIONS>;
+
+public:
+    HyperRectangle(const PointType& low, const PointType& high)
+        : Low(low)
+        , High(high)
+    {
+    }
+
+    bool IsEmpty() const {
+        for (size_t axis = 0; axis < DIMENSIONS; ++axis) {
+            if (Low[axis] > High[axis]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    CoordinateType GetLow(size_t axis) const {
+        return Low[axis];
+    }
+
+    CoordinateType GetHigh(size_t axis) const {
+        return High[axis];
+    }
+
+    PointType GetMiddlePoint() const {
+        PointType middle;
+        for (size_t axis = 0; axis < DIMENSIONS; ++axis) {
+            middle[axis] = Low[axis] + (High[axis] - Low[axis]) / 2;
+        }
+        return middle;
+    }
+
+    // Keeps the candidates at or below the bound along the axis
+    void KeepAtMost(size_t axis, CoordinateType bound) {
+        High[axis] = std::min(High[axis], bound);
+    }
+
+    // Keeps the candidates at or above the bound along the axis
+    void KeepAtLeast(size_t axis, CoordinateType bound) {
+        Low[axis] = std::max(Low[axis], bound);
+    }
+
+    void Pin(size_t axis, CoordinateType value) {
+        Low[axis] = High[axis] = value;
+    }
+
+    // Keeps the side the target lies on along every axis as seen from the probe. The probe itself is
+    // excluded, so a box the probe is inside of shrinks strictly.
+    void Narrow(const PointType& probe, const StepType& step) {
+        for (size_t axis = 0; axis < DIMENSIONS; ++axis) {
+            if (step[axis] < 0) {
+                KeepAtMost(axis, probe[axis] - 1);
+            } else if (step[axis] > 0) {
+                KeepAtLeast(axis, probe[axis] + 1);
+            } else {
+                Pin(axis, probe[axis]);
+            }
+        }
+    }
+
+private:
+    PointType Low;
+    PointType High;
+};
@@ -0,0 +1,98 @@
+#pragma once
+
+// Input side of the referee protocol, common to every puzzle
+
+#include <istream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+
+// Locale-free tokenizer which parses straight out of the stream buffer: no sentries, no facets
+// and no intermediate copies. It never looks past the end of the current token, so it can't block
+// on an interactive referee waiting for an answer.
+class InputReader {
+public:
+    explicit InputReader(std::istream& input)
+        : Buffer(*input.rdbuf())
+    {
+    }
+
+    long long ReadInteger() {
+        int c = SkipSpaces();
+        const bool isNegative = c == '-';
+        if (isNegative) {
+            c = Buffer.snextc();
+        }
+        if (!IsDigit(c)) {
+            throw std::runtime_error("An integer is expected in the input");
+        }
+
+        long long result = 0;
+        do {
+            result = result * 10 + (c - '0');
+            c = Buffer.snextc();
+        } while (IsDigit(c));
+        return isNegative ? -result : result;
+    }
+
+    // Blocks until the referee has sent at least one more byte (or closed the input) and consumes
+    // nothing: a turn's clock starts when its input arrives, not when it has been parsed
+    void WaitForInput() {
+        Buffer.sgetc();
+    }
+
+    // Whether there is another token: false once the referee has closed the input after the last one.
+    // Lets a game loop stop cleanly at the end of input, which the readers treat as an error.
+    bool HasMoreInput() {
+        int c = Buffer.sgetc();
+        while (IsSpace(c)) {
+            c = Buffer.snextc();
+        }
+        return c != EOF_CHAR;
+    }
+
+    // Reuses the word's buffer, so short-lived tokens cost no allocations
+    void ReadWord(std::string& word) {
+        word.clear();
+        for (int c = SkipSpaces(); c != EOF_CHAR && !IsSpace(c); c = Buffer.snextc()) {
+            word.push_back(static_cast<char>(c));
+        }
+    }
+
+private:
+    static constexpr int EOF_CHAR = std::char_traits<char>::eof();
+
+    std::streambuf& Buffer;
+
+private:
+    static bool IsDigit(int c) {
+        return c >= '0' && c <= '9';
+    }
+
+    static bool IsSpace(int c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+
+    int SkipSpaces() {
+        int c = Buffer.sgetc();
+        while (IsSpace(c)) {
+            c = Buffer.snextc();
+        }
+        if (c == EOF_CHAR) {
+            throw std::runtime_error("Unexpected end of input");
+        }
+        return c;
+    }
+};
+
+template <typename T>
+T Read(InputReader& input) {
+    if constexpr (std::is_integral_v<T>) {
+        return static_cast<T>(input.ReadInteger());
+    } else {
+        T result;
+        input.ReadWord(result);
+        return result;
+    }
+}
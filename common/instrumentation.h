@@ -0,0 +1,105 @@
+#pragma once
+
+// Opt-in per-phase counters of a solution's hot path
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// 1 - count calls and cycles of every decision phase; set it with `make INSTRUMENTATION=1`
+#ifndef INSTRUMENTATION
+#define INSTRUMENTATION 0
+#endif
+
+// Counters aggregated over the whole run and dumped as a single `key=value` line. PhaseType is
+// the solution's enum class of phases ending with COUNT, and GetPhaseName(PhaseType) names them.
+template <typename PhaseType>
+class Instrumentation {
+public:
+    static Instrumentation& Get() {
+        static Instrumentation instance;
+        return instance;
+    }
+
+    static uint64_t ReadCycles() {
+        #if INSTRUMENTATION && (defined(__x86_64__) || defined(__i386__))
+        return __rdtsc();
+        #elif INSTRUMENTATION
+        // No cycle counter available: nanoseconds will do
+        return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        #else
+        return 0;
+        #endif
+    }
+
+    void Record(PhaseType phase, uint64_t cycles) {
+        auto& counters = Phases[static_cast<size_t>(phase)];
+        ++counters.Calls;
+        counters.Cycles += cycles;
+    }
+
+    // Work items of a phase, e.g. the nodes a search expands
+    void AddNodes(PhaseType phase, uint64_t nodes) {
+        Phases[static_cast<size_t>(phase)].Nodes += nodes;
+    }
+
+    void Dump(std::ostream& os) const {
+        os << "instrumentation";
+        for (size_t i = 0; i < Phases.size(); ++i) {
+            const auto name = GetPhaseName(static_cast<PhaseType>(i));
+            os << ' ' << name << ".calls=" << Phases[i].Calls << ' ' << name << ".cycles=" << Phases[i].Cycles;
+        }
+        for (size_t i = 0; i < Phases.size(); ++i) {
+            if (Phases[i].Nodes != 0) {
+                os << ' ' << GetPhaseName(static_cast<PhaseType>(i)) << ".nodes=" << Phases[i].Nodes;
+            }
+        }
+        os << std::endl;
+    }
+
+private:
+    struct PhaseCounters {
+        uint64_t Calls = 0;
+        uint64_t Cycles = 0;
+        uint64_t Nodes = 0;
+    };
+
+    std::array<PhaseCounters, static_cast<size_t>(PhaseType::COUNT)> Phases = {};
+};
+
+// Charges the time until the end of the scope to a phase
+template <typename PhaseType>
+class PhaseTimer {
+public:
+    explicit PhaseTimer(PhaseType phase)
+        : MeasuredPhase(phase)
+        , Start(Instrumentation<PhaseType>::ReadCycles())
+    {
+    }
+
+    ~PhaseTimer() {
+        auto& instrumentation = Instrumentation<PhaseType>::Get();
+        instrumentation.Record(MeasuredPhase, Instrumentation<PhaseType>::ReadCycles() - Start);
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    PhaseType MeasuredPhase;
+    uint64_t Start;
+};
+
+#if INSTRUMENTATION
+#define INSTRUMENT_PHASE(phase) const PhaseTimer<decltype(phase)> phaseTimer(phase)
+#define INSTRUMENT_NODES(phase, nodes) Instrumentation<decltype(phase)>::Get().AddNodes(phase, nodes)
+#else
+#define INSTRUMENT_PHASE(phase)
+#define INSTRUMENT_NODES(phase, nodes)
+#endif
@@ -0,0 +1,100 @@
+#pragma once
+
+// Dense grids with run-time or compile-time dimensions
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+template <typename T>
+class Matrix {
+public:
+    Matrix(size_t columns, size_t rows)
+        : Columns(columns)
+        , Rows(rows)
+        , Data(Columns * Rows)
+    {
+    }
+
+    Matrix(size_t columns, size_t rows, const T& defaultValue)
+        : Columns(columns)
+        , Rows(rows)
+        , Data(Columns * Rows, defaultValue)
+    {
+    }
+
+    const T& Get(size_t column, size_t row) const {
+        return Data[AsRawIndex(column, row)];
+    }
+
+    void Set(size_t column, size_t row, const T& value) {
+        Data[AsRawIndex(column, row)] = value;
+    }
+
+    void Clear(const T& value) {
+        std::fill(Data.begin(), Data.end(), value);
+    }
+
+private:
+    using DataHolderType = std::vector<T>;
+
+    size_t Columns;
+    size_t Rows;
+    DataHolderType Data;
+
+private:
+    size_t AsRawIndex(size_t column, size_t row) const {
+        return static_cast<size_t>(row * Columns + column);
+    }
+};
+
+// Same interface as Matrix, but the dimensions are known at compile time: index math folds
+// into constants and the whole grid lives inline, with no heap storage.
+template <typename T, size_t COLUMNS, size_t ROWS>
+class StaticMatrix {
+public:
+    StaticMatrix() = default;
+
+    explicit StaticMatrix(const T& defaultValue) {
+        Clear(defaultValue);
+    }
+
+    // Mirrors the Matrix constructors so that both can be used interchangeably
+    StaticMatrix(size_t columns, size_t rows, const T& defaultValue = T())
+        : StaticMatrix(defaultValue)
+    {
+        if (columns != COLUMNS || rows != ROWS) {
+            throw std::runtime_error("StaticMatrix dimensions mismatch");
+        }
+    }
+
+    const T& Get(size_t column, size_t row) const {
+        return Data[AsRawIndex(column, row)];
+    }
+
+    void Set(size_t column, size_t row, const T& value) {
+        Data[AsRawIndex(column, row)] = value;
+    }
+
+    void Clear(const T& value) {
+        Data.fill(value);
+    }
+
+private:
+    std::array<T, COLUMNS * ROWS> Data = {};
+
+private:
+    static constexpr size_t AsRawIndex(size_t column, size_t row) {
+        return row * COLUMNS + column;
+    }
+};
+
+// Rows count of a matrix type known at compile time, zero when it's only known at run time
+template <typename T>
+struct StaticRows : std::integral_constant<size_t, 0> {};
+
+template <typename T, size_t COLUMNS, size_t ROWS>
+struct StaticRows<StaticMatrix<T, COLUMNS, ROWS>> : std::integral_constant<size_t, ROWS> {};
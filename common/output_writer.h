@@ -0,0 +1,64 @@
+#pragma once
+
+// Output side of the referee protocol, common to every puzzle
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+
+// Collects the whole answer of a turn and hands it over with a single write and a single flush
+class OutputWriter {
+public:
+    explicit OutputWriter(std::ostream& output)
+        : Output(output)
+    {
+    }
+
+    OutputWriter& operator<<(std::string_view text) {
+        Append(text.data(), text.size());
+        return *this;
+    }
+
+    OutputWriter& operator<<(long long value) {
+        std::array<char, MAX_INTEGER_LENGTH> digits;
+        const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+        Append(digits.data(), static_cast<size_t>(result.ptr - digits.data()));
+        return *this;
+    }
+
+    // Terminates the command line and sends it to the referee
+    void EndTurn() {
+        Append("\n", 1);
+        WriteOut();
+        Output.flush();
+    }
+
+private:
+    static constexpr size_t CAPACITY = 256;
+    static constexpr size_t MAX_INTEGER_LENGTH = 24;
+
+    std::ostream& Output;
+    std::array<char, CAPACITY> Buffer;
+    size_t Size = 0;
+
+private:
+    void Append(const char* data, size_t length) {
+        if (Size + length > Buffer.size()) {
+            WriteOut();
+        }
+        if (length > Buffer.size()) {
+            Output.write(data, static_cast<std::streamsize>(length));
+            return;
+        }
+        std::copy(data, data + length, Buffer.data() + Size);
+        Size += length;
+    }
+
+    void WriteOut() {
+        Output.write(Buffer.data(), static_cast<std::streamsize>(Size));
+        Size = 0;
+    }
+};
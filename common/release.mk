@@ -0,0 +1,69 @@
+# Optimized builds shared by the puzzles' Makefiles: they set NAME, CFLAGS, CXX, BENCHMARK_ARGS
+# and TRACE, and include this file after their own targets so that `all` stays the default one.
+
+# Which flags and profiling flow the compiler takes: clang or, for anything else, gcc's
+COMPILER_FAMILY := $(if $(findstring clang,$(shell $(CXX) --version 2>/dev/null)),clang,gcc)
+ifeq ($(COMPILER_FAMILY),gcc)
+# gcc warns about the #pragma region folds, which are only there for the editors
+CFLAGS += -Wno-unknown-pragmas
+endif
+
+# Link-time optimization when the toolchain can do it: a compiler without a matching LTO linker
+# plugin builds without it instead of failing at the link. gcc links in parallel with `auto`.
+ifndef LTO_FLAGS
+LTO_FLAG = $(if $(filter clang,$(COMPILER_FAMILY)),-flto,-flto=auto)
+LTO_FLAGS := $(shell echo 'int main() { return 0; }' | $(CXX) -x c++ $(LTO_FLAG) -o /dev/null - >/dev/null 2>&1 && echo $(LTO_FLAG))
+endif
+
+# What `all` builds: CodinGame compiles the submission itself, this is for running it locally
+RELEASE_FLAGS ?= -O2 $(LTO_FLAGS)
+# Tuned for the machine it's built on, so only for benchmarks run on that machine
+NATIVE_FLAGS ?= -O3 -march=native $(LTO_FLAGS)
+PROFDATA ?= llvm-profdata
+PGO_DIR ?= pgo
+# Replays of the trace in the training run of the PGO build and in each of its timing runs
+PGO_REPEATS ?= 200
+
+TURNS_PER_SECOND = sed -n 's|.*turns/sec \([0-9.]*\).*|\1|p'
+
+.PHONY: all windows benchmark benchmark-native replay pgo pgo-plain pgo-clang pgo-gcc submission
+
+benchmark-native:
+	$(CXX) $(CFLAGS) $(NATIVE_FLAGS) -pthread -o $(NAME)_benchmark_native.bin benchmark.cpp
+	./$(NAME)_benchmark_native.bin $(BENCHMARK_ARGS)
+
+# Two stages: an instrumented build plays $(TRACE) and leaves a profile, which then tunes the
+# solution and the replay harness. The same replays timed before and after give the speedup.
+pgo: pgo-$(COMPILER_FAMILY)
+	@before=$$(./$(PGO_DIR)/replay_plain.bin $(TRACE) $(PGO_REPEATS) | $(TURNS_PER_SECOND)); \
+	after=$$(./$(PGO_DIR)/replay_pgo.bin $(TRACE) $(PGO_REPEATS) | $(TURNS_PER_SECOND)); \
+	awk -v before="$$before" -v after="$$after" \
+		'BEGIN { printf "PGO speedup: %.2fx (%s -> %s turns/sec)\n", after / before, before, after }'
+
+pgo-plain:
+	rm -rf $(PGO_DIR) && mkdir -p $(PGO_DIR)
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -pthread -o $(PGO_DIR)/replay_plain.bin replay.cpp
+
+# clang matches the profile by function, so the replay harness trains the solution as well
+pgo-clang: pgo-plain
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -pthread -fprofile-instr-generate=$(PGO_DIR)/%p.profraw \
+		-o $(PGO_DIR)/replay_instrumented.bin replay.cpp
+	./$(PGO_DIR)/replay_instrumented.bin $(TRACE) $(PGO_REPEATS)
+	$(PROFDATA) merge -o $(PGO_DIR)/$(NAME).profdata $(PGO_DIR)/*.profraw
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -fprofile-instr-use=$(PGO_DIR)/$(NAME).profdata -o $(NAME).bin $(NAME).cpp
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -pthread -fprofile-instr-use=$(PGO_DIR)/$(NAME).profdata \
+		-o $(PGO_DIR)/replay_pgo.bin replay.cpp
+
+# gcc keeps a profile per object file, found next to it, so every object is built twice at the same
+# path; the solution itself is trained on the recorded input, piped in by tools/trace_input.py
+pgo-gcc: pgo-plain
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -pthread -fprofile-generate -c -o $(PGO_DIR)/replay.o replay.cpp
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -pthread -fprofile-generate -o $(PGO_DIR)/replay_instrumented.bin $(PGO_DIR)/replay.o
+	./$(PGO_DIR)/replay_instrumented.bin $(TRACE) $(PGO_REPEATS)
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -fprofile-generate -c -o $(PGO_DIR)/$(NAME).o $(NAME).cpp
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -fprofile-generate -o $(PGO_DIR)/$(NAME)_instrumented.bin $(PGO_DIR)/$(NAME).o
+	python3 ../tools/trace_input.py $(TRACE) | ./$(PGO_DIR)/$(NAME)_instrumented.bin >/dev/null
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -fprofile-use -c -o $(PGO_DIR)/$(NAME).o $(NAME).cpp
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -o $(NAME).bin $(PGO_DIR)/$(NAME).o
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -pthread -fprofile-use -c -o $(PGO_DIR)/replay.o replay.cpp
+	$(CXX) $(CFLAGS) $(RELEASE_FLAGS) -pthread -o $(PGO_DIR)/replay_pgo.bin $(PGO_DIR)/replay.o
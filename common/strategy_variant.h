@@ -0,0 +1,51 @@
+#pragma once
+
+// Run-time choice between strategies which are all known at compile time
+
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <variant>
+
+// One of the Strategies, picked by an enumerator of EnumType when the game starts: the enumerators
+// are the indices of the strategies in the list. A std::visit jump table stands in for a virtual
+// call through a heap object. All the strategies take the same constructor arguments and answer
+// with the same MakeDecision.
+template <typename EnumType, typename... Strategies>
+class StrategyVariant {
+public:
+    template <EnumType TYPE>
+    using StrategyOf = std::tuple_element_t<static_cast<size_t>(TYPE), std::tuple<Strategies...>>;
+
+public:
+    template <typename... Args>
+    explicit StrategyVariant(EnumType type, Args&&... args)
+        : Strategy(Create<0>(static_cast<size_t>(type), std::forward<Args>(args)...))
+    {
+    }
+
+    template <typename... Args>
+    auto MakeDecision(Args&&... args) {
+        return std::visit([&](auto& strategy) { return strategy.MakeDecision(std::forward<Args>(args)...); }, Strategy);
+    }
+
+private:
+    using VariantType = std::variant<Strategies...>;
+
+    VariantType Strategy;
+
+private:
+    // Strategies may be immovable, so the chosen one is built right in the variant
+    template <size_t INDEX, typename... Args>
+    static VariantType Create(size_t index, Args&&... args) {
+        if constexpr (INDEX < sizeof...(Strategies)) {
+            if (index == INDEX) {
+                return VariantType(std::in_place_index<INDEX>, std::forward<Args>(args)...);
+            }
+            return Create<INDEX + 1>(index, std::forward<Args>(args)...);
+        } else {
+            throw std::runtime_error("Unknown strategy type");
+        }
+    }
+};
@@ -0,0 +1,305 @@
+#pragma once
+
+// Binary record of a game as the solution saw it, for replaying it offline
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <string_view>
+
+// A trace is a flat sequence of records with no header and no offsets, so it can be mapped into memory
+// and walked in place. Every record starts with a varint of (payload size << 1 | kind):
+//   INPUT  - one line of the referee's input, as a sequence of tokens;
+//   OUTPUT - one command of the solution, the line's bytes without the line break.
+// An input token is a varint as well: (zigzag(value) << 1) for an integer, (length << 1 | 1) for
+// a word followed by its bytes. Integers are only those which print back exactly as they were read.
+enum class TraceRecordKind : uint8_t {
+    INPUT,
+    OUTPUT
+};
+
+inline void WriteVarint(std::string& buffer, uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<char>(value));
+}
+
+inline uint64_t ReadVarint(const uint8_t*& data, const uint8_t* end) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (data == end) {
+            throw std::runtime_error("The trace ends inside a varint");
+        }
+        const uint8_t byte = *data++;
+        result |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return result;
+        }
+    }
+    throw std::runtime_error("A varint of the trace is too long");
+}
+
+inline uint64_t ZigZagEncode(long long value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value < 0 ? -1 : 0);
+}
+
+inline long long ZigZagDecode(uint64_t value) {
+    return static_cast<long long>(value >> 1) ^ -static_cast<long long>(value & 1);
+}
+
+// Writes records to a file as the game goes: each command flushes, so a killed process loses nothing
+class TraceWriter {
+public:
+    explicit TraceWriter(const char* path)
+        : File(path, std::ios::binary)
+    {
+        if (!File) {
+            throw std::runtime_error("Can't open the trace file");
+        }
+    }
+
+    void AddInputLine(std::string_view line) {
+        Payload.clear();
+        size_t begin = 0;
+        while (begin < line.size()) {
+            const size_t end = std::min(line.find_first_of(" \t\r", begin), line.size());
+            if (end > begin) {
+                AddToken(line.substr(begin, end - begin));
+            }
+            begin = end + 1;
+        }
+        if (!Payload.empty()) {
+            WriteRecord(TraceRecordKind::INPUT);
+        }
+    }
+
+    void AddOutputLine(std::string_view line) {
+        Payload.assign(line.data(), line.size());
+        WriteRecord(TraceRecordKind::OUTPUT);
+        File.flush();
+    }
+
+private:
+    static constexpr size_t MAX_INTEGER_LENGTH = 18;
+
+    std::ofstream File;
+    std::string Payload;
+    std::string Header;
+
+private:
+    void AddToken(std::string_view token) {
+        long long value = 0;
+        if (ParseCanonicalInteger(token, value)) {
+            WriteVarint(Payload, ZigZagEncode(value) << 1);
+        } else {
+            WriteVarint(Payload, (static_cast<uint64_t>(token.size()) << 1) | 1);
+            Payload.append(token.data(), token.size());
+        }
+    }
+
+    void WriteRecord(TraceRecordKind kind) {
+        Header.clear();
+        WriteVarint(Header, (static_cast<uint64_t>(Payload.size()) << 1) | static_cast<uint64_t>(kind));
+        File.write(Header.data(), static_cast<std::streamsize>(Header.size()));
+        File.write(Payload.data(), static_cast<std::streamsize>(Payload.size()));
+    }
+
+    // "-0", "007" and the like are kept as words, so that the input is restored byte for byte
+    static bool ParseCanonicalInteger(std::string_view token, long long& value) {
+        const bool isNegative = !token.empty() && token[0] == '-';
+        const auto digits = token.substr(isNegative ? 1 : 0);
+        if (digits.empty() || digits.size() > MAX_INTEGER_LENGTH || (digits[0] == '0' && (digits.size() > 1 || isNegative))) {
+            return false;
+        }
+        value = 0;
+        for (const char c : digits) {
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            value = value * 10 + (c - '0');
+        }
+        value = isNegative ? -value : value;
+        return true;
+    }
+};
+
+// Passes the referee's input through unchanged and records whatever the solution reads, line by line.
+// It gets a single character from the source at a time, so it never reads further than the solution
+// does and the order of lines and commands in the trace is the order of the game.
+class TraceInputBuffer final : public std::streambuf {
+public:
+    TraceInputBuffer(std::streambuf& source, TraceWriter& writer)
+        : Source(source)
+        , Writer(writer)
+    {
+    }
+
+    // A command may answer a line which the solution hasn't read up to its end yet
+    void FlushLine() {
+        Writer.AddInputLine(Line);
+        Line.clear();
+    }
+
+protected:
+    int_type underflow() override {
+        const int_type c = Source.sbumpc();
+        if (traits_type::eq_int_type(c, traits_type::eof())) {
+            return c;
+        }
+        Current = traits_type::to_char_type(c);
+        setg(&Current, &Current, &Current + 1);
+        if (Current == '\n') {
+            FlushLine();
+        } else {
+            Line.push_back(Current);
+        }
+        return c;
+    }
+
+private:
+    std::streambuf& Source;
+    TraceWriter& Writer;
+    std::string Line;
+    char Current = 0;
+};
+
+// Passes the solution's commands through to the referee and records every complete line
+class TraceOutputBuffer final : public std::streambuf {
+public:
+    TraceOutputBuffer(std::streambuf& target, TraceWriter& writer, TraceInputBuffer& input)
+        : Target(target)
+        , Writer(writer)
+        , Input(input)
+    {
+    }
+
+protected:
+    int_type overflow(int_type c) override {
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            const char data = traits_type::to_char_type(c);
+            xsputn(&data, 1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize length) override {
+        for (std::streamsize i = 0; i < length; ++i) {
+            if (data[i] != '\n') {
+                Line.push_back(data[i]);
+                continue;
+            }
+            Input.FlushLine();
+            Writer.AddOutputLine(Line);
+            Line.clear();
+        }
+        return Target.sputn(data, length);
+    }
+
+    int sync() override {
+        return Target.pubsync();
+    }
+
+private:
+    std::streambuf& Target;
+    TraceWriter& Writer;
+    TraceInputBuffer& Input;
+    std::string Line;
+};
+
+// The streams a solution talks to the referee through: the given ones, or the same ones recorded
+// into a trace file when there is a path (solution.bin [trace file]).
+class TraceRecorder {
+public:
+    TraceRecorder(std::istream& input, std::ostream& output, const char* path)
+        : Writer(path == nullptr ? nullptr : std::make_unique<TraceWriter>(path))
+        , InputBuffer(Writer == nullptr ? nullptr : std::make_unique<TraceInputBuffer>(*input.rdbuf(), *Writer))
+        , OutputBuffer(Writer == nullptr ? nullptr : std::make_unique<TraceOutputBuffer>(*output.rdbuf(), *Writer, *InputBuffer))
+        , Input(InputBuffer == nullptr ? input.rdbuf() : InputBuffer.get())
+        , Output(OutputBuffer == nullptr ? output.rdbuf() : OutputBuffer.get())
+    {
+    }
+
+    std::istream& GetInput() {
+        return Input;
+    }
+
+    std::ostream& GetOutput() {
+        return Output;
+    }
+
+private:
+    std::unique_ptr<TraceWriter> Writer;
+    std::unique_ptr<TraceInputBuffer> InputBuffer;
+    std::unique_ptr<TraceOutputBuffer> OutputBuffer;
+    std::istream Input;
+    std::ostream Output;
+};
+
+// Walks the records of a trace in place
+class TraceReader {
+public:
+    struct Record {
+        TraceRecordKind Kind;
+        const uint8_t* Data;
+        size_t Size;
+    };
+
+public:
+    TraceReader(const uint8_t* data, size_t size)
+        : Position(data)
+        , End(data + size)
+    {
+    }
+
+    bool IsOver() const {
+        return Position == End;
+    }
+
+    Record Next() {
+        const uint64_t header = ReadVarint(Position, End);
+        const auto size = static_cast<size_t>(header >> 1);
+        if (size > static_cast<size_t>(End - Position)) {
+            throw std::runtime_error("The trace ends inside a record");
+        }
+        const Record record{static_cast<TraceRecordKind>(header & 1), Position, size};
+        Position += size;
+        return record;
+    }
+
+    // The input line of an INPUT record as the referee sent it, the tokens separated by spaces
+    static void DecodeInputLine(const Record& record, std::string& line) {
+        line.clear();
+        const uint8_t* data = record.Data;
+        const uint8_t* const end = record.Data + record.Size;
+        while (data != end) {
+            if (!line.empty()) {
+                line.push_back(' ');
+            }
+            const uint64_t token = ReadVarint(data, end);
+            if ((token & 1) == 0) {
+                line += std::to_string(ZigZagDecode(token >> 1));
+                continue;
+            }
+            const auto length = static_cast<size_t>(token >> 1);
+            if (length > static_cast<size_t>(end - data)) {
+                throw std::runtime_error("The trace ends inside a word");
+            }
+            line.append(reinterpret_cast<const char*>(data), length);
+            data += length;
+        }
+        line.push_back('\n');
+    }
+
+private:
+    const uint8_t* Position;
+    const uint8_t* End;
+};
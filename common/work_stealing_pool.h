@@ -0,0 +1,141 @@
+#pragma once
+
+// Thread pool for the offline, many-core use of the solutions: CodinGame itself runs them on a single core
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool running batches of independent tasks. Every worker pops tasks from the front of
+// its own queue, and once it's empty steals from the back of the others' ones, so a few long tasks
+// don't leave the rest of the cores idle. The calling thread works as worker 0.
+// A batch allocates nothing once the queues have grown to its size: the task is called through a
+// plain pointer instead of a std::function, and the queues keep their storage between the batches.
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(size_t workersCount)
+        : Queues(std::max<size_t>(workersCount, 1))
+    {
+        for (size_t worker = 1; worker < Queues.size(); ++worker) {
+            Threads.emplace_back([this, worker]() { WorkerLoop(worker); });
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    ~WorkStealingPool() {
+        {
+            const std::lock_guard<std::mutex> lock(Mutex);
+            IsStopping = true;
+        }
+        WakeUp.notify_all();
+        for (auto& thread : Threads) {
+            thread.join();
+        }
+    }
+
+    size_t GetWorkersCount() const {
+        return Queues.size();
+    }
+
+    // Runs task(index, worker) for every index in [0, tasksCount) and returns once all of them are done
+    template <typename TaskType>
+    void Run(size_t tasksCount, const TaskType& task) {
+        {
+            const std::lock_guard<std::mutex> lock(Mutex);
+            CurrentTask = &task;
+            CallTask = [](const void* taskObject, size_t index, size_t worker) {
+                (*static_cast<const TaskType*>(taskObject))(index, worker);
+            };
+            Pending = tasksCount;
+            ++Batch;
+            for (auto& queue : Queues) {
+                const std::lock_guard<std::mutex> queueLock(queue.Mutex);
+                queue.Tasks.clear();
+                queue.Front = 0;
+            }
+            for (size_t i = 0; i < tasksCount; ++i) {
+                auto& queue = Queues[i % Queues.size()];
+                const std::lock_guard<std::mutex> queueLock(queue.Mutex);
+                queue.Tasks.push_back(i);
+            }
+        }
+        WakeUp.notify_all();
+
+        Work(0);
+        std::unique_lock<std::mutex> lock(Mutex);
+        Done.wait(lock, [this]() { return Pending == 0; });
+        CurrentTask = nullptr;
+        CallTask = nullptr;
+    }
+
+private:
+    // The tasks left are [Front, Tasks.size()): the owner takes them from the front, thieves from the back
+    struct TaskQueue {
+        std::mutex Mutex;
+        std::vector<size_t> Tasks;
+        size_t Front = 0;
+    };
+
+    std::vector<TaskQueue> Queues;
+    std::vector<std::thread> Threads;
+    std::mutex Mutex;
+    std::condition_variable WakeUp;
+    std::condition_variable Done;
+    const void* CurrentTask = nullptr;
+    void (*CallTask)(const void* task, size_t index, size_t worker) = nullptr;
+    size_t Pending = 0;
+    uint64_t Batch = 0;
+    bool IsStopping = false;
+
+private:
+    void WorkerLoop(size_t worker) {
+        uint64_t seenBatch = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(Mutex);
+                WakeUp.wait(lock, [&]() { return IsStopping || Batch != seenBatch; });
+                if (IsStopping) {
+                    return;
+                }
+                seenBatch = Batch;
+            }
+            Work(worker);
+        }
+    }
+
+    void Work(size_t worker) {
+        size_t task = 0;
+        while (TryPop(worker, task)) {
+            CallTask(CurrentTask, task, worker);
+            const std::lock_guard<std::mutex> lock(Mutex);
+            if (--Pending == 0) {
+                Done.notify_all();
+            }
+        }
+    }
+
+    bool TryPop(size_t worker, size_t& task) {
+        for (size_t i = 0; i < Queues.size(); ++i) {
+            auto& queue = Queues[(worker + i) % Queues.size()];
+            const std::lock_guard<std::mutex> lock(queue.Mutex);
+            if (queue.Front == queue.Tasks.size()) {
+                continue;
+            }
+            // Own tasks in order, stolen ones from the other end to stay out of the owner's way
+            if (i == 0) {
+                task = queue.Tasks[queue.Front++];
+            } else {
+                task = queue.Tasks.back();
+                queue.Tasks.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+};
@@ -0,0 +1,221 @@
+// Offline referee for Power of Thor: generates giant swarms from a seed and plays them in-process
+// against World, reporting per-turn latency, throughput and win rate. It also counts the heap
+// allocations of every turn after the first one and fails when there are any: a game under way
+// is expected to run on the buffers it has already got.
+//
+// Usage: power_of_thor_ep_2_benchmark.bin [games] [seed] [max giants] [threads] [strategy] [distance search]
+//     [turn budget ms]
+// where the strategy is a StrategyType index: 0 - FOLLOW_MOST_DISTANT, 1 - LOOKAHEAD_SEARCH. The turn
+// budget is 0 by default: the search goes SEARCH_MAX_DEPTH deep every turn, so a seed always plays the
+// same games. A budget such as the game's 40 ms times the search as it plays on CodinGame.
+
+#define SOLUTION_NO_MAIN
+#include "power_of_thor_ep_2.cpp"
+
+#include "../common/benchmark.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+
+namespace {
+
+// Allocations made by the calling thread, so that concurrent games don't see each other's
+thread_local size_t ThreadAllocations = 0;
+
+} // namespace
+
+void* operator new(size_t size) {
+    ++ThreadAllocations;
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t /* size */) noexcept {
+    std::free(memory);
+}
+
+// Only the puzzle's map is played with; this keeps the one for the other sizes compiling
+template class BasicGameWorldMap<DynamicMatrix>;
+
+namespace {
+
+// The first turn may still size buffers, such as Thor's giant list
+constexpr int WARM_UP_TURNS = 1;
+
+std::atomic<size_t> SteadyAllocations{0};
+
+class ThorReferee {
+public:
+    ThorReferee(std::mt19937& random, int maxGiants) {
+        std::uniform_int_distribution<int> xs(0, MAP_WIDTH - 1);
+        std::uniform_int_distribution<int> ys(0, MAP_HEIGHT - 1);
+        ThorPosition = {xs(random), ys(random)};
+
+        const int amount = std::uniform_int_distribution<int>(1, maxGiants)(random);
+        while (static_cast<int>(Giants.size()) < amount) {
+            const Point giant = {xs(random), ys(random)};
+            // A giant next to Thor would finish the game before it even starts
+            if (ManhattanDistance(giant, ThorPosition) > 1) {
+                Giants.push_back(giant);
+            }
+        }
+        Strikes = std::uniform_int_distribution<int>(std::max(1, amount / 10), std::max(1, amount / 3))(random);
+    }
+
+    bool IsOver() const {
+        return IsFinished;
+    }
+
+    bool IsWon() const {
+        return HasWon;
+    }
+
+    void WriteInitialInput(std::ostream& os) const {
+        os << ThorPosition.X << ' ' << ThorPosition.Y << '\n';
+    }
+
+    void WriteTurnInput(std::ostream& os) const {
+        os << Strikes << ' ' << Giants.size() << '\n';
+        for (const auto& giant : Giants) {
+            os << giant.X << ' ' << giant.Y << '\n';
+        }
+    }
+
+    void ApplyCommand(const std::string& command) {
+        ++Turns;
+        if (command == "STRIKE") {
+            if (Strikes <= 0) {
+                return Finish(false);
+            }
+            --Strikes;
+            Giants.erase(std::remove_if(Giants.begin(), Giants.end(), [&](const Point& giant) {
+                return ManhattanDistance(giant, ThorPosition) <= STRIKE_RADIUS;
+            }), Giants.end());
+        } else if (!MoveThor(command)) {
+            return Finish(false);
+        }
+
+        if (Giants.empty() || Turns >= MAX_TURNS) {
+            return Finish(Giants.empty());
+        }
+
+        for (auto& giant : Giants) {
+            giant = giant + Point{Sign(ThorPosition.X - giant.X), Sign(ThorPosition.Y - giant.Y)};
+            if (giant.X == ThorPosition.X && giant.Y == ThorPosition.Y) {
+                return Finish(false);
+            }
+        }
+    }
+
+private:
+    static constexpr int MAP_WIDTH = 40;
+    static constexpr int MAP_HEIGHT = 18;
+    static constexpr int STRIKE_RADIUS = 4;
+    static constexpr int MAX_TURNS = 500;
+
+    Point ThorPosition;
+    std::vector<Point> Giants;
+    int Strikes = 0;
+    int Turns = 0;
+    bool IsFinished = false;
+    bool HasWon = false;
+
+private:
+    static int Sign(int value) {
+        return (value > 0) - (value < 0);
+    }
+
+    void Finish(bool isWon) {
+        IsFinished = true;
+        HasWon = isWon;
+    }
+
+    bool MoveThor(const std::string& command) {
+        Point dir;
+        for (const char c : command == "WAIT" ? std::string() : command) {
+            switch (c) {
+                case 'N': dir.Y = -1; break;
+                case 'S': dir.Y = 1; break;
+                case 'E': dir.X = 1; break;
+                case 'W': dir.X = -1; break;
+                default: return false;
+            }
+        }
+        ThorPosition = ThorPosition + dir;
+        return ThorPosition.X >= 0 && ThorPosition.X < MAP_WIDTH && ThorPosition.Y >= 0 && ThorPosition.Y < MAP_HEIGHT;
+    }
+};
+
+bool PlayGame(ThorReferee& referee, StrategyType strategy, DistanceSearchType distanceSearch,
+    std::chrono::milliseconds turnBudget, BenchmarkStats& stats)
+{
+    MemoryChannel toSolution;
+    MemoryChannel toReferee;
+    std::iostream input(&toSolution);
+    std::iostream output(&toReferee);
+    InputReader reader(input);
+    OutputWriter writer(output);
+
+    referee.WriteInitialInput(input);
+    try {
+        BasicWorld<AnyStrategy> world(reader, strategy, distanceSearch);
+        world.SetTurnBudget(turnBudget);
+        for (int turn = 0; !referee.IsOver(); ++turn) {
+            referee.WriteTurnInput(input);
+            size_t allocations = 0;
+            stats.AddTurn(MeasureCall([&] {
+                allocations = ThreadAllocations;
+                world.NextStep(reader, writer);
+                allocations = ThreadAllocations - allocations;
+            }));
+            if (turn >= WARM_UP_TURNS) {
+                SteadyAllocations += allocations;
+            }
+
+            std::string command;
+            std::getline(output, command);
+            referee.ApplyCommand(command);
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return referee.IsWon();
+}
+
+} // namespace
+
+int main(int argc, const char** argv) {
+    const auto games = GetArgument(argc, argv, 1, 1000);
+    const auto seed = GetArgument(argc, argv, 2, 42);
+    const auto maxGiants = static_cast<int>(GetArgument(argc, argv, 3, 100));
+    // The instrumentation counters are shared by the whole process
+    const auto threads = INSTRUMENTATION ? 1 : static_cast<size_t>(GetArgument(argc, argv, 4, 1));
+    const auto strategy = static_cast<StrategyType>(GetArgument(argc, argv, 5, static_cast<uint64_t>(StrategyType::THOR_STRATEGY)));
+    const auto distanceSearch = static_cast<DistanceSearchType>(
+        GetArgument(argc, argv, 6, static_cast<uint64_t>(DistanceSearchType::DISTANCE_SEARCH)));
+    const auto turnBudget = std::chrono::milliseconds(GetArgument(argc, argv, 7, 0));
+
+    auto stats = RunGames(games, threads, [&](uint64_t game, BenchmarkStats& gameStats) {
+        auto random = MakeGameRandom(seed, game);
+        ThorReferee referee(random, maxGiants);
+        return PlayGame(referee, strategy, distanceSearch, turnBudget, gameStats);
+    });
+    stats.Report(std::cout, "power_of_thor_ep_2");
+    #if INSTRUMENTATION
+    Instrumentation<Phase>::Get().Dump(std::cout);
+    #endif
+
+    if (SteadyAllocations > 0) {
+        std::cout << "FAILED: " << SteadyAllocations << " heap allocations in turns after the first one\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,25 +1,108 @@
 #include <algorithm>
+#include <array>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <exception>
 #include <iostream>
+#include <iterator>
 #include <limits>
-#include <memory>
-#include <queue>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
-#define PRINT_DEBUG_INFO
+// 0 - no tracing, 1 - decisions, 2 - decisions and the world map; set it with `make TRACE_LEVEL=...`
+#define TRACE_LEVEL_OFF 0
+#define TRACE_LEVEL_DECISIONS 1
+#define TRACE_LEVEL_MAP 2
+
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL TRACE_LEVEL_OFF
+#endif
+
+// The strategy World plays with, see StrategyType; set it with `make THOR_STRATEGY=...`
+#ifndef THOR_STRATEGY
+#define THOR_STRATEGY FOLLOW_MOST_DISTANT
+#endif
+
+// How FollowMostDistant measures safe distances, see DistanceSearchType; set it with `make DISTANCE_SEARCH=...`
+#ifndef DISTANCE_SEARCH
+#define DISTANCE_SEARCH THOR_NEIGHBOURHOOD
+#endif
+
+// Wall-clock time of a turn, from the first byte of its input to the command; strategies which can use
+// more time (the lookahead search) stop there. 0 - no limit, the search goes SEARCH_MAX_DEPTH deep.
+#ifndef TURN_TIME_BUDGET_MS
+#define TURN_TIME_BUDGET_MS 40
+#endif
+
+#ifndef SEARCH_MAX_DEPTH
+#define SEARCH_MAX_DEPTH 12
+#endif
+
+// Threads evaluating the lookahead search's root moves; the decisions don't depend on it
+#ifndef SEARCH_THREADS
+#define SEARCH_THREADS 1
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define HAS_X86_INTRINSICS
+#include <immintrin.h>
+#include <x86intrin.h>
+#endif
 
 #pragma region("INPUT UTILS")
-template <typename T>
-T Read(std::istream& input) {
-    T result;
-    input >> result;
-    return result;
+#include "../common/input_reader.h"
+#pragma endregion
+
+#pragma region("OUTPUT UTILS")
+#include "../common/output_writer.h"
+#include "../common/debug_output.h"
+#include "../common/trace.h"
+#pragma endregion
+
+#pragma region("INSTRUMENTATION")
+#include "../common/instrumentation.h"
+
+enum class Phase {
+    FILL_WORLD_MAP,
+    CLEAR_WORLD_MAP,
+    FIND_ALLOWED_POSITIONS,
+    FIND_MOST_DISTANT_GIANT,
+    FIND_DISTANCES_TO_POINT,
+    FIND_NEXT_POSITION,
+    COUNT
+};
+
+const char* GetPhaseName(Phase phase) {
+    static constexpr const char* names[] = {
+        "fill_world_map",
+        "clear_world_map",
+        "find_allowed_positions",
+        "find_most_distant_giant",
+        "find_distances_to_point",
+        "find_next_position"
+    };
+    static_assert(std::size(names) == static_cast<size_t>(Phase::COUNT));
+    return names[static_cast<size_t>(phase)];
 }
 #pragma endregion
 
+#pragma region("TIME UTILS")
+#include "../common/deadline.h"
+#pragma endregion
+
+#pragma region("MEMORY UTILS")
+#include "../common/arena.h"
+#pragma endregion
+
+#pragma region("THREADING UTILS")
+#include "../common/work_stealing_pool.h"
+#pragma endregion
+
 #pragma region("MATH UTILS")
 constexpr int INF = std::numeric_limits<int>::max();
 
@@ -27,7 +110,7 @@ struct Point {
     int X = 0;
     int Y = 0;
 
-    static Point FromStream(std::istream& input) {
+    static Point FromStream(InputReader& input) {
         const auto x = Read<int>(input);
         const auto y = Read<int>(input);
         return {x, y};
@@ -61,6 +144,111 @@ bool IsInRadius(const Point& point, const Point& center, int radius) {
     return ManhattanDistance(point, center) <= radius;
 }
 
+// Result of a distance scan over a batch of points: the farthest one (the first of equals) and how many
+// are within the radius. Distances are Chebyshev ones, as everywhere else.
+struct DistanceScan {
+    int MaxDistance = -1;
+    size_t MaxIndex = 0;
+    size_t InRadius = 0;
+};
+
+DistanceScan ScanDistancesScalar(const int8_t* xs, const int8_t* ys, size_t begin, size_t end,
+    const Point& center, int radius, DistanceScan result = {})
+{
+    for (size_t i = begin; i < end; ++i) {
+        const int distance = ManhattanDistance({xs[i], ys[i]}, center);
+        if (distance > result.MaxDistance) {
+            result.MaxDistance = distance;
+            result.MaxIndex = i;
+        }
+        result.InRadius += static_cast<size_t>(distance <= radius);
+    }
+    return result;
+}
+
+#ifdef HAS_X86_INTRINSICS
+// Coordinates are below 64, so every difference fits into a signed byte and a register covers 16 (32) points
+__attribute__((target("sse4.1")))
+inline int HorizontalMax(__m128i values) {
+    values = _mm_max_epi8(values, _mm_srli_si128(values, 8));
+    values = _mm_max_epi8(values, _mm_srli_si128(values, 4));
+    values = _mm_max_epi8(values, _mm_srli_si128(values, 2));
+    values = _mm_max_epi8(values, _mm_srli_si128(values, 1));
+    return static_cast<int8_t>(_mm_cvtsi128_si32(values) & 0xFF);
+}
+
+__attribute__((target("sse4.1")))
+DistanceScan ScanDistancesSse(const int8_t* xs, const int8_t* ys, size_t count, const Point& center, int radius) {
+    constexpr size_t LANES = 16;
+    const __m128i centerX = _mm_set1_epi8(static_cast<char>(center.X));
+    const __m128i centerY = _mm_set1_epi8(static_cast<char>(center.Y));
+    const __m128i radiusLanes = _mm_set1_epi8(static_cast<char>(std::min(radius, 127)));
+
+    DistanceScan result;
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        const __m128i dx = _mm_abs_epi8(_mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(xs + i)), centerX));
+        const __m128i dy = _mm_abs_epi8(_mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ys + i)), centerY));
+        const __m128i distances = _mm_max_epi8(dx, dy);
+
+        const int chunkMax = HorizontalMax(distances);
+        if (chunkMax > result.MaxDistance) {
+            const auto isMax = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(distances, _mm_set1_epi8(static_cast<char>(chunkMax)))));
+            result.MaxDistance = chunkMax;
+            result.MaxIndex = i + static_cast<size_t>(__builtin_ctz(isMax));
+        }
+        const auto isOutside = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(distances, radiusLanes)));
+        result.InRadius += LANES - static_cast<size_t>(__builtin_popcount(isOutside));
+    }
+    return ScanDistancesScalar(xs, ys, i, count, center, radius, result);
+}
+
+__attribute__((target("avx2")))
+DistanceScan ScanDistancesAvx2(const int8_t* xs, const int8_t* ys, size_t count, const Point& center, int radius) {
+    constexpr size_t LANES = 32;
+    const __m256i centerX = _mm256_set1_epi8(static_cast<char>(center.X));
+    const __m256i centerY = _mm256_set1_epi8(static_cast<char>(center.Y));
+    const __m256i radiusLanes = _mm256_set1_epi8(static_cast<char>(std::min(radius, 127)));
+
+    DistanceScan result;
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        const __m256i dx = _mm256_abs_epi8(_mm256_sub_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs + i)), centerX));
+        const __m256i dy = _mm256_abs_epi8(_mm256_sub_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys + i)), centerY));
+        const __m256i distances = _mm256_max_epi8(dx, dy);
+
+        const int chunkMax = HorizontalMax(_mm_max_epi8(_mm256_castsi256_si128(distances), _mm256_extracti128_si256(distances, 1)));
+        if (chunkMax > result.MaxDistance) {
+            const auto isMax = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(distances, _mm256_set1_epi8(static_cast<char>(chunkMax)))));
+            result.MaxDistance = chunkMax;
+            result.MaxIndex = i + static_cast<size_t>(__builtin_ctz(isMax));
+        }
+        const auto isOutside = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpgt_epi8(distances, radiusLanes)));
+        result.InRadius += LANES - static_cast<size_t>(__builtin_popcount(isOutside));
+    }
+    return ScanDistancesScalar(xs, ys, i, count, center, radius, result);
+}
+#endif
+
+// Picks the widest kernel the CPU supports once, the build flags don't have to enable any of them
+DistanceScan ScanDistances(const int8_t* xs, const int8_t* ys, size_t count, const Point& center, int radius) {
+    using KernelType = DistanceScan (*)(const int8_t*, const int8_t*, size_t, const Point&, int);
+    static const KernelType kernel = []() -> KernelType {
+        #ifdef HAS_X86_INTRINSICS
+        if (__builtin_cpu_supports("avx2")) {
+            return ScanDistancesAvx2;
+        }
+        if (__builtin_cpu_supports("sse4.1")) {
+            return ScanDistancesSse;
+        }
+        #endif
+        return [](const int8_t* xs, const int8_t* ys, size_t count, const Point& center, int radius) {
+            return ScanDistancesScalar(xs, ys, 0, count, center, radius);
+        };
+    }();
+    return kernel(xs, ys, count, center, radius);
+}
+
 std::ostream& WritePoint(std::ostream& os, const Point& p, const std::string& msg = "") {
     if (!msg.empty()) {
         os << msg << ": ";
@@ -69,48 +257,62 @@ std::ostream& WritePoint(std::ostream& os, const Point& p, const std::string& ms
     return os;
 }
 
-template <typename T>
-class Matrix {
+#include "../common/matrix.h"
+
+// 2D prefix sums over per-cell counts: the total over any rectangle is an O(1) query.
+// Fill it with Add(), then call Accumulate() once before querying.
+template <typename MatrixType>
+class SummedAreaTable {
 public:
-    Matrix(size_t columns, size_t rows)
-        : Columns(columns)
-        , Rows(rows)
-        , Data(Columns * Rows)
+    SummedAreaTable(size_t columns, size_t rows)
+        : Columns(static_cast<int>(columns))
+        , Rows(static_cast<int>(rows))
+        , Sums(columns, rows, 0)
     {
     }
 
-    Matrix(size_t columns, size_t rows, const T& defaultValue)
-        : Columns(columns)
-        , Rows(rows)
-        , Data(Columns * Rows, defaultValue)
-    {
+    void Clear() {
+        Sums.Clear(0);
     }
 
-    const T& Get(size_t column, size_t row) const {
-        return Data[AsRawIndex(column, row)];
+    void Add(const Point& position) {
+        Sums.Set(position.X, position.Y, Sums.Get(position.X, position.Y) + 1);
     }
 
-    void Set(size_t column, size_t row, const T& value) {
-        Data[AsRawIndex(column, row)] = value;
+    void Accumulate() {
+        for (int y = 0; y < Rows; ++y) {
+            int rowSum = 0;
+            for (int x = 0; x < Columns; ++x) {
+                rowSum += Sums.Get(x, y);
+                Sums.Set(x, y, rowSum + (y > 0 ? Sums.Get(x, y - 1) : 0));
+            }
+        }
     }
 
-    void Clear(const T& value) {
-        std::fill(Data.begin(), Data.end(), value);
+    // Total within the Chebyshev radius of the center, clipped to the table
+    int CountInSquare(const Point& center, int radius) const {
+        const int firstX = std::max(center.X - radius, 0);
+        const int firstY = std::max(center.Y - radius, 0);
+        const int lastX = std::min(center.X + radius, Columns - 1);
+        const int lastY = std::min(center.Y + radius, Rows - 1);
+        if (firstX > lastX || firstY > lastY) {
+            return 0;
+        }
+        return SumUpTo(lastX, lastY) - SumUpTo(firstX - 1, lastY) - SumUpTo(lastX, firstY - 1) + SumUpTo(firstX - 1, firstY - 1);
     }
 
 private:
-    using DataHolderType = std::vector<T>;
+    int Columns;
+    int Rows;
+    MatrixType Sums;
 
 private:
-    size_t Columns;
-    size_t Rows;
-    DataHolderType Data;
-
-private:
-    size_t AsRawIndex(size_t column, size_t row) const {
-        return static_cast<size_t>(row * Columns + column);
+    int SumUpTo(int x, int y) const {
+        return x < 0 || y < 0 ? 0 : Sums.Get(x, y);
     }
 };
+
+#include "../common/bitboard.h"
 #pragma endregion
 
 #pragma region("GAME-SPECIFIC UTILS")
@@ -129,27 +331,19 @@ const std::vector<Point>& GetPossibleDirections() {
     return directions;
 }
 
-std::string GetSymbolicDirection(const Point& current, const Point& desired) {
-    std::string result;
-    const auto dir = desired - current;
-
-    if (dir.Y > 0) {
-        result += "S";
-    } else if (dir.Y < 0) {
-        result += "N";
-    }
-
-    if (dir.X > 0) {
-        result += "E";
-    } else if (dir.X < 0) {
-        result += "W";
-    }
-    
-    if (result.empty()) {
-        result = "WAIT";
-    }
+const char* GetSymbolicDirection(const Point& current, const Point& desired) {
+    // Indexed by [sign(dy) + 1][sign(dx) + 1]
+    static constexpr const char* directions[3][3] = {
+        {"NW", "N", "NE"},
+        {"W", "WAIT", "E"},
+        {"SW", "S", "SE"}
+    };
+    const auto sign = [](int value) {
+        return (value > 0) - (value < 0);
+    };
 
-    return result;
+    const auto dir = desired - current;
+    return directions[sign(dir.Y) + 1][sign(dir.X) + 1];
 }
 #pragma endregion
 
@@ -171,6 +365,10 @@ public:
         return StrikesLeft;
     }
 
+    int GetStrikeRadius() const {
+        return StrikeRadius;
+    }
+
     bool CanStrike(const Point& position) const {
         return ManhattanDistance(position, Position) <= StrikeRadius;
     }
@@ -179,6 +377,10 @@ public:
         Position = position;
     }
 
+    void SetStrikes(int strikesLeft) {
+        StrikesLeft = strikesLeft;
+    }
+
     void Strike() {
         if (StrikesLeft <= 0) {
             throw std::runtime_error("Not enough charges!");
@@ -192,9 +394,11 @@ private:
     int StrikesLeft = 0;
 };
 
+class GiantList;
+
 class Giant {
 public:
-    using ListType = std::vector<Giant>;
+    using ListType = GiantList;
 
 public:
     explicit Giant(const Point& position)
@@ -210,7 +414,120 @@ private:
     Point Position;
 };
 
-class GameWorldMap {
+// Giants as separate x and y arrays of bytes, which ScanDistances consumes as they are. The puzzle never
+// has more than INLINE_CAPACITY of them, so the arrays live inline; a bigger crowd spills to the heap
+// and the spilled buffers are reused afterwards. Clear() keeps both, so refilling allocates nothing.
+class GiantList {
+public:
+    static constexpr size_t INLINE_CAPACITY = 128;
+
+    class Iterator {
+    public:
+        Iterator(const GiantList& list, size_t index)
+            : List(list)
+            , Index(index)
+        {
+        }
+
+        Giant operator*() const {
+            return List[Index];
+        }
+
+        Iterator& operator++() {
+            ++Index;
+            return *this;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return Index != other.Index;
+        }
+
+    private:
+        const GiantList& List;
+        size_t Index;
+    };
+
+public:
+    void Clear() {
+        Count = 0;
+    }
+
+    void PushBack(const Point& position) {
+        if (Count < INLINE_CAPACITY) {
+            InlineX[Count] = static_cast<int8_t>(position.X);
+            InlineY[Count] = static_cast<int8_t>(position.Y);
+            ++Count;
+            return;
+        }
+        if (Count == INLINE_CAPACITY) {
+            Spill();
+        }
+        SpilledX.push_back(static_cast<int8_t>(position.X));
+        SpilledY.push_back(static_cast<int8_t>(position.Y));
+        ++Count;
+    }
+
+    Giant operator[](size_t index) const {
+        return Giant({X()[index], Y()[index]});
+    }
+
+    const int8_t* X() const {
+        return IsSpilled() ? SpilledX.data() : InlineX.data();
+    }
+
+    const int8_t* Y() const {
+        return IsSpilled() ? SpilledY.data() : InlineY.data();
+    }
+
+    Iterator begin() const {
+        return {*this, 0};
+    }
+
+    Iterator end() const {
+        return {*this, Count};
+    }
+
+    size_t size() const {
+        return Count;
+    }
+
+    bool empty() const {
+        return Count == 0;
+    }
+
+private:
+    bool IsSpilled() const {
+        return Count > INLINE_CAPACITY;
+    }
+
+    // The heap buffers keep their capacity, so only the first spill of a game allocates
+    void Spill() {
+        SpilledX.assign(InlineX.begin(), InlineX.end());
+        SpilledY.assign(InlineY.begin(), InlineY.end());
+    }
+
+private:
+    size_t Count = 0;
+    std::array<int8_t, INLINE_CAPACITY> InlineX;
+    std::array<int8_t, INLINE_CAPACITY> InlineY;
+    std::vector<int8_t> SpilledX;
+    std::vector<int8_t> SpilledY;
+};
+
+// The puzzle is always played on a 40x18 board, other sizes need BasicGameWorldMap<DynamicMatrix>
+constexpr size_t PUZZLE_MAP_WIDTH = 40;
+constexpr size_t PUZZLE_MAP_HEIGHT = 18;
+
+template <typename T>
+using PuzzleMatrix = StaticMatrix<T, PUZZLE_MAP_WIDTH, PUZZLE_MAP_HEIGHT>;
+
+template <typename T>
+using DynamicMatrix = Matrix<T>;
+
+// Thor is a single cell, so only the giants need a plane of their own: together with the danger layer
+// the puzzle map is two bit planes of 18 words each, instead of a 16-bit enum per cell.
+template <template <typename> class MatrixType>
+class BasicGameWorldMap {
 public:
     enum class CellType : uint16_t {
         EMPTY,
@@ -218,11 +535,20 @@ public:
         GIANT
     };
 
+    // Matrix of the same flavour as the map itself, for per-cell data such as distances
+    template <typename T>
+    using LayerType = MatrixType<T>;
+
+    // Bit planes hold as many rows as the matrices do, when those are known at compile time
+    using BoardType = BasicBitBoard<StaticRows<LayerType<bool>>::value != 0
+        ? StaticRows<LayerType<bool>>::value : BitBoard::MAX_ROWS>;
+
 public:
-    GameWorldMap(int mapWidth, int mapHeight)
+    BasicGameWorldMap(int mapWidth, int mapHeight)
         : MapWidth(mapWidth)
         , MapHeight(mapHeight)
-        , Cells(static_cast<size_t>(MapWidth), static_cast<size_t>(MapHeight), CellType::EMPTY)
+        , Giants(static_cast<size_t>(MapWidth), static_cast<size_t>(MapHeight))
+        , Dangers(static_cast<size_t>(MapWidth), static_cast<size_t>(MapHeight))
     {
     }
 
@@ -235,7 +561,11 @@ public:
     }
 
     CellType GetEntity(const Point& position) const {
-        return Cells.Get(static_cast<size_t>(position.X), static_cast<size_t>(position.Y));
+        if (HasGiant(position)) {
+            return CellType::GIANT;
+        }
+        return IsThorPlaced && position.X == ThorPosition.X && position.Y == ThorPosition.Y
+            ? CellType::THOR : CellType::EMPTY;
     }
 
     bool IsOnMap(const Point& position) const {
@@ -243,55 +573,201 @@ public:
     }
 
     bool HasGiant(const Point& position) const {
-        return GetEntity(position) == CellType::GIANT;
+        return Giants.Get(static_cast<size_t>(position.X), static_cast<size_t>(position.Y));
+    }
+
+    // A cell is dangerous if some giant can reach it in one turn
+    bool IsDangerous(const Point& position) const {
+        return Dangers.Get(static_cast<size_t>(position.X), static_cast<size_t>(position.Y));
+    }
+
+    const BoardType& GetDangers() const {
+        return Dangers;
     }
 
     void Clear(const Point& position) {
-        Set(position, CellType::EMPTY);
+        Giants.Reset(static_cast<size_t>(position.X), static_cast<size_t>(position.Y));
+        if (position.X == ThorPosition.X && position.Y == ThorPosition.Y) {
+            IsThorPlaced = false;
+        }
     }
 
     void Clear() {
-        Cells.Clear(CellType::EMPTY);
+        Giants.Clear();
+        Dangers.Clear();
+        IsThorPlaced = false;
     }
 
+    // Overlapping reaches can't be un-stamped one by one, but this costs a single word per row
+    void ClearDangers() {
+        Dangers.Clear();
+    }
+
+    // A cell holds a single entity, the one placed last
     void PlaceThor(const Point& position) {
-        Set(position, CellType::THOR);
+        Giants.Reset(static_cast<size_t>(position.X), static_cast<size_t>(position.Y));
+        ThorPosition = position;
+        IsThorPlaced = true;
     }
 
     void PlaceGiant(const Point& position) {
-        Set(position, CellType::GIANT);
+        Giants.Set(static_cast<size_t>(position.X), static_cast<size_t>(position.Y));
+        Dangers.SetSquare(position.X, position.Y, GIANT_REACH);
     }
 
 private:
+    static constexpr int GIANT_REACH = 1;
+
     const int MapWidth;
     const int MapHeight;
-    Matrix<CellType> Cells;
+    Point ThorPosition;
+    bool IsThorPlaced = false;
+    BoardType Giants;
+    BoardType Dangers;
+};
 
-private:
-    void Set(const Point& position, CellType value) {
-        Cells.Set(static_cast<size_t>(position.X), static_cast<size_t>(position.Y), value);
+using GameWorldMap = BasicGameWorldMap<PuzzleMatrix>;
+
+// What stays the same during a game: GameState doesn't carry it to keep its copies small
+struct GameRules {
+    int MapWidth = 0;
+    int MapHeight = 0;
+    int StrikeRadius = 0;
+};
+
+// Flat snapshot of a game for searches and simulations: giants are stored as separate x and y arrays
+// of bytes (the board is at most 64x64), so a copy is a single memcpy of a few hundred bytes.
+struct GameState {
+    static constexpr size_t MAX_GIANTS = 256;
+
+    int8_t ThorX = 0;
+    int8_t ThorY = 0;
+    int16_t Strikes = 0;
+    uint16_t GiantsCount = 0;
+    std::array<int8_t, MAX_GIANTS> GiantsX;
+    std::array<int8_t, MAX_GIANTS> GiantsY;
+
+    static bool CanHold(size_t giantsCount) {
+        return giantsCount <= MAX_GIANTS;
+    }
+
+    static GameState FromWorld(const Thor& thor, const Giant::ListType& giants) {
+        if (!CanHold(giants.size())) {
+            throw std::runtime_error("Too many giants for GameState");
+        }
+
+        GameState state;
+        state.ThorX = static_cast<int8_t>(thor.GetPosition().X);
+        state.ThorY = static_cast<int8_t>(thor.GetPosition().Y);
+        state.Strikes = static_cast<int16_t>(thor.GetStrikes());
+        state.GiantsCount = static_cast<uint16_t>(giants.size());
+        std::copy_n(giants.X(), giants.size(), state.GiantsX.begin());
+        std::copy_n(giants.Y(), giants.size(), state.GiantsY.begin());
+        return state;
+    }
+
+    Point GetThorPosition() const {
+        return {ThorX, ThorY};
+    }
+
+    Point GetGiantPosition(size_t index) const {
+        return {GiantsX[index], GiantsY[index]};
+    }
+
+    bool IsWon() const {
+        return GiantsCount == 0;
+    }
+
+    DistanceScan ScanGiants(int radius) const {
+        return ScanDistances(GiantsX.data(), GiantsY.data(), GiantsCount, GetThorPosition(), radius);
+    }
+
+    // False if Thor would leave the map
+    bool MoveThor(const Point& dir, const GameRules& rules) {
+        const auto next = GetThorPosition() + dir;
+        if (next.X < 0 || next.X >= rules.MapWidth || next.Y < 0 || next.Y >= rules.MapHeight) {
+            return false;
+        }
+        ThorX = static_cast<int8_t>(next.X);
+        ThorY = static_cast<int8_t>(next.Y);
+        return true;
+    }
+
+    // Kills every giant within the strike radius; false if there are no charges left
+    bool Strike(const GameRules& rules) {
+        if (Strikes <= 0) {
+            return false;
+        }
+        --Strikes;
+        if (ScanGiants(rules.StrikeRadius).InRadius == 0) {
+            return true;
+        }
+
+        uint16_t alive = 0;
+        for (size_t i = 0; i < GiantsCount; ++i) {
+            if (ManhattanDistance(GetGiantPosition(i), GetThorPosition()) > rules.StrikeRadius) {
+                GiantsX[alive] = GiantsX[i];
+                GiantsY[alive] = GiantsY[i];
+                ++alive;
+            }
+        }
+        GiantsCount = alive;
+        return true;
+    }
+
+    // Every giant steps towards Thor; false if one of them catches him
+    bool MoveGiants() {
+        const auto stepTowards = [](int8_t from, int8_t to) {
+            return static_cast<int8_t>(from + (from < to) - (to < from));
+        };
+
+        bool isCaught = false;
+        for (size_t i = 0; i < GiantsCount; ++i) {
+            GiantsX[i] = stepTowards(GiantsX[i], ThorX);
+            GiantsY[i] = stepTowards(GiantsY[i], ThorY);
+            isCaught |= GiantsX[i] == ThorX && GiantsY[i] == ThorY;
+        }
+        return !isCaught;
     }
 };
+
+static_assert(std::is_trivially_copyable_v<GameState>, "GameState must be copyable with memcpy");
 #pragma endregion
 
 #pragma region("STRATEGY")
-class IStrategy {
-public:
-    virtual ~IStrategy() = default;
-
-    virtual std::string MakeDecision() = 0;
+#include "../common/strategy_variant.h"
+
+// Every strategy is built from the world it plays in, (map, giants, Thor), and answers a turn with a
+// `std::string_view MakeDecision(const Deadline&)`, moving Thor or spending a strike as it answers.
+// A strategy which may think for long returns its best answer so far once the deadline passes, and
+// the greedy FollowMostDistant, which always answers at once, is the fallback of any other one.
+
+// Both give the same distances to the cells a turn asks about, and so the same moves
+enum class DistanceSearchType {
+    // The field covers the whole reachable board
+    FULL_FIELD,
+    // Rings stop as soon as Thor's cell and his moves are settled: a target nearby costs only
+    // the few rings around it
+    THOR_NEIGHBOURHOOD
 };
 
-class FollowMostDistant final : public IStrategy {
+class FollowMostDistant final {
 public:
-    FollowMostDistant(const GameWorldMap& worldMap, const Giant::ListType& giants, Thor& thor)
+    FollowMostDistant(const GameWorldMap& worldMap, const Giant::ListType& giants, Thor& thor,
+        DistanceSearchType distanceSearch = DistanceSearchType::DISTANCE_SEARCH)
         : WorldMap(worldMap)
         , Giants(giants)
         , Player(thor)
+        , DistanceSearch(distanceSearch)
+        , Scratch(ScratchSize())
+        , Field(worldMap)
+        , GiantCounts(static_cast<size_t>(worldMap.GetMapWidth()), static_cast<size_t>(worldMap.GetMapHeight()))
     {
     }
 
-    std::string MakeDecision() override {
+    // Takes a few microseconds, so there's no point in looking at the clock
+    std::string_view MakeDecision(const Deadline& /* deadline */) {
+        Scratch.Reset();
         if (Giants.empty()) {
             return "WAIT";
         }
@@ -303,74 +779,137 @@ public:
         }
 
         const auto& mostDistantGiant = FindMostDistantGiant();
-        if (Player.CanStrike(mostDistantGiant.GetPosition())) {
+        if (Player.CanStrike(mostDistantGiant.GetPosition()) || IsStrikeWorthIt(allowedPositions)) {
             Player.Strike();
             return "STRIKE";
         }
 
         const auto nextPosition = FindNextPosition(mostDistantGiant, allowedPositions);
 
-        #ifdef PRINT_DEBUG_INFO
-        WritePoint(std::cerr, Player.GetPosition(), "Thor") << std::endl;
-        WritePoint(std::cerr, mostDistantGiant.GetPosition(), "Giant") << std::endl;
-        WritePoint(std::cerr, nextPosition, "Next position") << std::endl;
+        #if TRACE_LEVEL >= TRACE_LEVEL_DECISIONS
+        WritePoint(DebugOutput(), Player.GetPosition(), "Thor") << '\n';
+        WritePoint(DebugOutput(), mostDistantGiant.GetPosition(), "Giant") << '\n';
+        WritePoint(DebugOutput(), nextPosition, "Next position") << '\n';
+        DebugOutput() << "Distance rings: " << Field.Rings << '\n';
         #endif
 
         return MoveThor(nextPosition);
     }
 
 private:
-    using DistanceMap = Matrix<int>;
+    using DistanceMap = GameWorldMap::LayerType<int>;
+    using PositionList = ArenaArray<Point>;
+
+    // The flood fill's buffers, kept from turn to turn so that no turn allocates. The field itself
+    // is rebuilt every turn: giants move every turn, and so do the target and the danger layer.
+    // Visited cells have their final distances, the frontier is where the flood fill goes on.
+    struct DistanceField {
+        explicit DistanceField(const GameWorldMap& worldMap)
+            : Distances(static_cast<size_t>(worldMap.GetMapWidth()), static_cast<size_t>(worldMap.GetMapHeight()), INF)
+            , Visited(static_cast<size_t>(worldMap.GetMapWidth()), static_cast<size_t>(worldMap.GetMapHeight()))
+            , Frontier(static_cast<size_t>(worldMap.GetMapWidth()), static_cast<size_t>(worldMap.GetMapHeight()))
+        {
+        }
+
+        DistanceMap Distances;
+        GameWorldMap::BoardType Visited;
+        GameWorldMap::BoardType Frontier;
+        size_t Rings = 0;
+    };
 
 private:
     const GameWorldMap& WorldMap;
     const Giant::ListType& Giants;
     Thor& Player;
+    const DistanceSearchType DistanceSearch;
+    ScratchArena Scratch;
+    DistanceField Field;
+    SummedAreaTable<GameWorldMap::LayerType<int>> GiantCounts;
 
 private:
-    std::string MoveThor(const Point& nextPosition) {
+    static size_t ScratchSize() {
+        return ScratchArena::Footprint<Point>(GetPossibleDirections().size());
+    }
+
+    const char* MoveThor(const Point& nextPosition) {
         const auto dir = GetSymbolicDirection(Player.GetPosition(), nextPosition);
         Player.SetPosition(nextPosition);
         return dir;
     }
 
-    Point FindNextPosition(const Giant& mostDistantGiant, std::vector<Point>& allowedPositions) const {
+    // Includes the time of the distance search, which is also reported on its own
+    Point FindNextPosition(const Giant& mostDistantGiant, const PositionList& allowedPositions) {
+        INSTRUMENT_PHASE(Phase::FIND_NEXT_POSITION);
         const auto& playerPosition = Player.GetPosition();
         const auto& giantPosition = mostDistantGiant.GetPosition();
-        const auto distances = FindDistancesToPoint(giantPosition);
+        const auto& distances = GetDistancesToPoint(giantPosition, allowedPositions);
         if (distances.Get(playerPosition.X, playerPosition.Y) != INF) {
-            std::sort(allowedPositions.begin(), allowedPositions.end(), [&](const Point& lhs, const Point& rhs) {
-                const auto lhsDistance = distances.Get(lhs.X, lhs.Y);
-                const auto rhsDistance = distances.Get(rhs.X, rhs.Y);
-                if (lhsDistance == rhsDistance) {
-                    return EuclidDistance(lhs, giantPosition) < EuclidDistance(rhs, giantPosition);
-                }
-                return lhsDistance < rhsDistance;
-            });
-        } else {
-            std::sort(allowedPositions.begin(), allowedPositions.end(), [&](const Point& lhs, const Point& rhs) {
-                return ManhattanDistance(lhs, giantPosition) < ManhattanDistance(rhs, giantPosition);
+            // Safe distance first, then the Euclid distance: comparing squares gives the same order without sqrt
+            return FindMinByKey(allowedPositions, [&](const Point& position) {
+                const auto diff = position - giantPosition;
+                const auto distance = static_cast<uint64_t>(distances.Get(position.X, position.Y));
+                return (distance << 32) | static_cast<uint64_t>(DotProduct(diff, diff));
             });
         }
 
-        return allowedPositions.front();
+        return FindMinByKey(allowedPositions, [&](const Point& position) {
+            return static_cast<uint64_t>(ManhattanDistance(position, giantPosition));
+        });
     }
 
-    bool HasAdjacentGiants(const Point& position) const {
-        for (const auto& dir : GetPossibleDirections()) {
-            const auto adjacentPosition = position + dir;
-            if (!WorldMap.IsOnMap(adjacentPosition)) {
-                continue;
-            }
-            if (WorldMap.HasGiant(adjacentPosition)) {
-                return true;
+    // The position with the smallest key, the earliest one of those with equal keys. The std::sort this
+    // replaced left the order of equal keys unspecified, so on ties the pick may differ from the first
+    // element of the sorted list it used to take.
+    template <typename KeyFunction>
+    static Point FindMinByKey(const PositionList& positions, const KeyFunction& key) {
+        size_t bestIdx = 0;
+        uint64_t bestKey = key(positions[0]);
+        for (size_t i = 1; i < positions.size(); ++i) {
+            const uint64_t candidateKey = key(positions[i]);
+            const bool isBetter = candidateKey < bestKey;
+            bestKey = isBetter ? candidateKey : bestKey;
+            bestIdx = isBetter ? i : bestIdx;
+        }
+        return positions[bestIdx];
+    }
+
+    // Ranks "strike now" against "move to an allowed cell, strike next turn" by kills per charge.
+    // Giants step one cell closer meanwhile, so who is within radius + 1 of the cell is hit next turn.
+    // Striking now pays off when it kills at least the average a charge has to and waiting can't do better.
+    bool IsStrikeWorthIt(const PositionList& allowedPositions) {
+        const int strikes = Player.GetStrikes();
+        if (strikes <= 0) {
+            return false;
+        }
+
+        GiantCounts.Clear();
+        for (const auto& giant : Giants) {
+            GiantCounts.Add(giant.GetPosition());
+        }
+        GiantCounts.Accumulate();
+
+        const int radius = Player.GetStrikeRadius();
+        const int killsNow = GiantCounts.CountInSquare(Player.GetPosition(), radius);
+        const int killsPerCharge = (static_cast<int>(Giants.size()) + strikes - 1) / strikes;
+        if (killsNow < killsPerCharge) {
+            return false;
+        }
+
+        for (const auto& position : allowedPositions) {
+            if (GiantCounts.CountInSquare(position, radius + 1) > killsNow) {
+                return false;
             }
         }
-        return false;
+        return true;
+    }
+
+    bool HasAdjacentGiants(const Point& position) const {
+        return WorldMap.IsDangerous(position);
     }
 
-    std::vector<Point> FindAllowedPositions() const {
-        std::vector<Point> result;
+    PositionList FindAllowedPositions() {
+        INSTRUMENT_PHASE(Phase::FIND_ALLOWED_POSITIONS);
+        auto result = Scratch.Allocate<Point>(GetPossibleDirections().size());
         const auto playerPosition = Player.GetPosition();
         for (const auto& dir : GetPossibleDirections()) {
             const auto nextPosition = playerPosition + dir;
@@ -378,94 +917,363 @@ private:
                 continue;
             }
             if (!HasAdjacentGiants(nextPosition)) {
-                result.push_back(nextPosition);
+                result.PushBack(nextPosition);
             }
         }
         return result;
     }
 
-    const Giant& FindMostDistantGiant() const {
-        size_t maxIdx = 0;
-        int maxDistance = 0;
-        for (size_t i = 0; i < Giants.size(); ++i) {
-            const auto& giant = Giants[i];
-            const int distanceToGiant = ManhattanDistance(giant.GetPosition(), Player.GetPosition());
-            if (maxDistance < distanceToGiant) {
-                maxDistance = distanceToGiant;
-                maxIdx = i;
-            }
+    Giant FindMostDistantGiant() const {
+        INSTRUMENT_PHASE(Phase::FIND_MOST_DISTANT_GIANT);
+        const auto scan = ScanDistances(Giants.X(), Giants.Y(), Giants.size(), Player.GetPosition(), 0);
+        return Giants[scan.MaxIndex];
+    }
+
+    // Only Thor's cell and the allowed positions are read, so these are what has to be settled
+    const DistanceMap& GetDistancesToPoint(const Point& point, const PositionList& allowedPositions) {
+        if (DistanceSearch == DistanceSearchType::FULL_FIELD) {
+            FindDistancesToPoint(point, [] { return false; });
+        } else {
+            const auto& playerPosition = Player.GetPosition();
+            FindDistancesToPoint(point, [&] {
+                const auto isSettled = [&](const Point& position) {
+                    return Field.Visited.Get(static_cast<size_t>(position.X), static_cast<size_t>(position.Y));
+                };
+                return isSettled(playerPosition) && std::all_of(allowedPositions.begin(), allowedPositions.end(), isSettled);
+            });
+        }
+        return Field.Distances;
+    }
+
+    // Flood fill over bitboards: each iteration produces a whole ring of cells at the same distance.
+    // Only safe cells are expanded further, except the target's immediate neighbours: they are always
+    // within the target giant's reach, so nothing would be expanded at all otherwise.
+    // Goes on until the board runs out of reachable cells or isDone() says the rest isn't needed.
+    template <typename DoneFunction>
+    void FindDistancesToPoint(const Point& point, const DoneFunction& isDone) {
+        INSTRUMENT_PHASE(Phase::FIND_DISTANCES_TO_POINT);
+        auto& distances = Field.Distances;
+        distances.Clear(INF);
+        Field.Visited.Clear();
+        Field.Frontier.Clear();
+        Field.Rings = 0;
+
+        distances.Set(point.X, point.Y, 0);
+        Field.Visited.Set(point.X, point.Y);
+        Field.Frontier.Set(point.X, point.Y);
+
+        for (int distance = 1; !Field.Frontier.IsEmpty() && !isDone(); ++distance) {
+            INSTRUMENT_NODES(Phase::FIND_DISTANCES_TO_POINT, Field.Frontier.Count());
+            const auto ring = Field.Frontier.Dilated().Without(Field.Visited);
+            Field.Visited |= ring;
+            ring.ForEachSet([&](size_t column, size_t row) {
+                distances.Set(column, row, distance);
+            });
+            Field.Frontier = distance == 1 ? ring : ring.Without(WorldMap.GetDangers());
+            ++Field.Rings;
         }
-        return Giants[maxIdx];
     }
+};
 
-    DistanceMap FindDistancesToPoint(const Point& point) const {
-        using VisitedMap = Matrix<uint8_t>;
+// Zobrist keys: XOR-ed for Thor and the strikes, added for giants, since several giants may share a cell
+class ZobristKeys {
+public:
+    static const ZobristKeys& Get() {
+        static const ZobristKeys keys;
+        return keys;
+    }
+
+    uint64_t Hash(const GameState& state) const {
+        const int strikes = std::min(static_cast<int>(state.Strikes), MAX_STRIKES);
+        uint64_t result = ThorKeys[AsIndex(state.GetThorPosition())] ^ StrikesKeys[strikes];
+        for (size_t i = 0; i < state.GiantsCount; ++i) {
+            result += GiantKeys[AsIndex(state.GetGiantPosition(i))];
+        }
+        return result;
+    }
+
+private:
+    static constexpr size_t CELLS = BitBoard::MAX_COLUMNS * BitBoard::MAX_ROWS;
+    static constexpr int MAX_STRIKES = 255;
 
-        DistanceMap distances(WorldMap.GetMapWidth(), WorldMap.GetMapHeight(), INF);
-        VisitedMap visited(WorldMap.GetMapWidth(), WorldMap.GetMapHeight(), false);
-        std::queue<Point> toVisit;
+    std::array<uint64_t, CELLS> ThorKeys;
+    std::array<uint64_t, CELLS> GiantKeys;
+    std::array<uint64_t, MAX_STRIKES + 1> StrikesKeys;
 
-        const auto setDistance = [&](const Point& position, int distance) {
-            distances.Set(position.X, position.Y, distance);
-            visited.Set(position.X, position.Y, true);
+private:
+    ZobristKeys() {
+        // splitmix64: the keys are the same on every run, and so are the decisions
+        uint64_t seed = 0x9E3779B97F4A7C15ull;
+        const auto next = [&seed]() {
+            uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
         };
+        std::generate(ThorKeys.begin(), ThorKeys.end(), next);
+        std::generate(GiantKeys.begin(), GiantKeys.end(), next);
+        std::generate(StrikesKeys.begin(), StrikesKeys.end(), next);
+    }
 
-        const auto findToVisit = [&, this](const Point& position) {
-            for (const auto& candidateDir : GetPossibleDirections()) {
-                const auto candidateToVisit = position + candidateDir;
-                if (!WorldMap.IsOnMap(candidateToVisit) || visited.Get(candidateToVisit.X, candidateToVisit.Y)) {
-                    continue;
-                }
-                setDistance(candidateToVisit, distances.Get(position.X, position.Y) + 1);
-                if (!HasAdjacentGiants(candidateToVisit)) {
-                    toVisit.push(candidateToVisit);
-                }
+    static size_t AsIndex(const Point& position) {
+        return static_cast<size_t>(position.Y) * BitBoard::MAX_COLUMNS + static_cast<size_t>(position.X);
+    }
+};
+
+// Searches several turns ahead with iterative deepening until the time budget of the turn runs out.
+// Giants are deterministic (each one steps straight towards Thor), so it's a single-agent search
+// where only the leaves need a heuristic. When every line loses or the position doesn't fit into
+// GameState, the greedy FollowMostDistant answer is played instead.
+// The root moves are searched in parallel, each with its own transposition table shard, so a
+// move's value doesn't depend on which worker searched it or on what the others have seen.
+class LookaheadSearch final {
+public:
+    LookaheadSearch(const GameWorldMap& worldMap, const Giant::ListType& giants, Thor& thor,
+        DistanceSearchType distanceSearch = DistanceSearchType::DISTANCE_SEARCH)
+        : WorldMap(worldMap)
+        , Giants(giants)
+        , Player(thor)
+        , Fallback(worldMap, giants, thor, distanceSearch)
+        , Rules{worldMap.GetMapWidth(), worldMap.GetMapHeight(), thor.GetStrikeRadius()}
+        , Pool(SEARCH_THREADS)
+    {
+        for (auto& context : Contexts) {
+            context.Table.resize(TRANSPOSITION_TABLE_SIZE);
+        }
+    }
+
+    std::string_view MakeDecision(const Deadline& deadline) {
+        if (Giants.empty() || !GameState::CanHold(Giants.size()) || deadline.IsExpired()) {
+            return Fallback.MakeDecision(deadline);
+        }
+
+        const auto root = GameState::FromWorld(Player, Giants);
+        const int strikes = std::max(static_cast<int>(root.Strikes), 1);
+        StrikeValue = GIANT_VALUE * ((root.GiantsCount + strikes - 1) / strikes);
+        TurnDeadline = deadline;
+        ++Generation;
+        for (auto& context : Contexts) {
+            context.Nodes = 0;
+        }
+
+        int bestAction = NO_ACTION;
+        for (int depth = 1; depth <= MAX_DEPTH; ++depth) {
+            const auto [action, value] = SearchRoot(root, depth);
+            if (IsOutOfTime()) {
+                break;
             }
-        };
+            bestAction = value > LOSS_VALUE / 2 ? action : NO_ACTION;
+            if (value > WIN_VALUE / 2 || value < LOSS_VALUE / 2) {
+                break; // the outcome is already known, looking deeper changes nothing
+            }
+        }
 
-        setDistance(point, 0);
-        for (const auto& dir : GetPossibleDirections()) {
-            const auto nextPosition = point + dir;
-            if (!WorldMap.IsOnMap(nextPosition) || visited.Get(nextPosition.X, nextPosition.Y)) {
-                continue;
+        #if TRACE_LEVEL >= TRACE_LEVEL_DECISIONS
+        size_t nodes = 0;
+        for (const auto& context : Contexts) {
+            nodes += context.Nodes;
+        }
+        DebugOutput() << "Search action: " << bestAction << "; nodes: " << nodes << '\n';
+        #endif
+
+        if (bestAction == NO_ACTION) {
+            return Fallback.MakeDecision(deadline);
+        }
+        if (bestAction == STRIKE_ACTION) {
+            Player.Strike();
+            return "STRIKE";
+        }
+        const auto nextPosition = Player.GetPosition() + GetPossibleDirections()[static_cast<size_t>(bestAction)];
+        const auto dir = GetSymbolicDirection(Player.GetPosition(), nextPosition);
+        Player.SetPosition(nextPosition);
+        return dir;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = SEARCH_MAX_DEPTH;
+    static constexpr int NO_ACTION = -1;
+    static constexpr int STRIKE_ACTION = 9;
+    static constexpr int ACTIONS_COUNT = 10;
+    static constexpr int WIN_VALUE = 1 << 28;
+    static constexpr int LOSS_VALUE = -WIN_VALUE;
+    static constexpr int GIANT_VALUE = 1000;
+    static constexpr int NEAR_GIANT_VALUE = 10;
+    static constexpr int SAFE_MOVE_VALUE = 3;
+    static constexpr size_t TRANSPOSITION_TABLE_SIZE = 1 << 14;
+    static constexpr size_t NODES_PER_CLOCK_CHECK = 128;
+
+    struct TableEntry {
+        uint64_t Key = 0;
+        uint32_t Generation = 0;
+        int Depth = 0;
+        int Value = 0;
+    };
+
+    // Everything the search of a single root move writes to
+    struct SearchContext {
+        std::vector<TableEntry> Table;
+        size_t Nodes = 0;
+        bool IsOutOfTime = false;
+        int Value = 0;
+    };
+
+    const GameWorldMap& WorldMap;
+    const Giant::ListType& Giants;
+    Thor& Player;
+    FollowMostDistant Fallback;
+    GameRules Rules;
+    std::array<SearchContext, ACTIONS_COUNT> Contexts;
+    WorkStealingPool Pool;
+    uint32_t Generation = 0;
+    int StrikeValue = GIANT_VALUE;
+    Deadline TurnDeadline = Deadline::Never();
+
+private:
+    std::pair<int, int> SearchRoot(const GameState& root, int depth) {
+        Pool.Run(ACTIONS_COUNT, [&](size_t action, size_t /* worker */) {
+            auto& context = Contexts[action];
+            context.IsOutOfTime = false;
+            auto child = root;
+            context.Value = ApplyAction(child, static_cast<int>(action)) ? Search(child, depth - 1, 1, context) : LOSS_VALUE;
+        });
+
+        // Reduced in the order of the actions, to break ties the same way every time
+        int bestAction = NO_ACTION;
+        int bestValue = LOSS_VALUE - 1;
+        for (int action = 0; action < ACTIONS_COUNT; ++action) {
+            const int value = Contexts[static_cast<size_t>(action)].Value;
+            if (value > bestValue) {
+                bestValue = value;
+                bestAction = action;
             }
-            setDistance(nextPosition, 1);
-            findToVisit(nextPosition);
+        }
+        return {bestAction, bestValue};
+    }
+
+    bool IsOutOfTime() const {
+        return std::any_of(Contexts.begin(), Contexts.end(), [](const auto& context) { return context.IsOutOfTime; });
+    }
+
+    int Search(const GameState& state, int depth, int ply, SearchContext& context) {
+        // Leaves are counted as well: they are most of the nodes and Evaluate is the costly part
+        if (++context.Nodes % NODES_PER_CLOCK_CHECK == 0 && TurnDeadline.IsExpired()) {
+            context.IsOutOfTime = true;
+        }
+        if (context.IsOutOfTime) {
+            return 0;
+        }
+        if (state.GiantsCount == 0) {
+            return WIN_VALUE - ply; // the sooner the better
+        }
+        if (state.Strikes == 0) {
+            return LOSS_VALUE + ply; // giants stay, there's nothing to kill them with
+        }
+        if (depth == 0) {
+            return Evaluate(state);
         }
 
-        while (!toVisit.empty()) {
-            const auto& next = toVisit.front();
-            findToVisit(next);
-            toVisit.pop();
+        const uint64_t key = ZobristKeys::Get().Hash(state);
+        auto& entry = context.Table[key & (context.Table.size() - 1)];
+        if (entry.Key == key && entry.Generation == Generation && entry.Depth >= depth) {
+            return entry.Value;
         }
 
-        return distances;
+        int bestValue = LOSS_VALUE + ply;
+        for (int action = 0; action < ACTIONS_COUNT; ++action) {
+            auto child = state;
+            if (ApplyAction(child, action)) {
+                bestValue = std::max(bestValue, Search(child, depth - 1, ply + 1, context));
+            }
+        }
+
+        if (!context.IsOutOfTime) {
+            entry = {key, Generation, depth, bestValue};
+        }
+        return bestValue;
+    }
+
+    // Plays Thor's action and the giants' answer; false if the action is illegal or Thor gets caught
+    bool ApplyAction(GameState& state, int action) const {
+        const bool isLegal = action == STRIKE_ACTION
+            ? state.Strike(Rules)
+            : state.MoveThor(GetPossibleDirections()[static_cast<size_t>(action)], Rules);
+        return isLegal && state.MoveGiants();
+    }
+
+    // A charge is worth as many giants as it has to kill on average, so spending it on fewer is a loss.
+    // Giants gathered within the strike radius and free cells around Thor break the ties.
+    int Evaluate(const GameState& state) const {
+        int value = StrikeValue * state.Strikes - GIANT_VALUE * static_cast<int>(state.GiantsCount);
+        value += NEAR_GIANT_VALUE * static_cast<int>(state.ScanGiants(Rules.StrikeRadius).InRadius);
+
+        GameWorldMap::BoardType dangers(static_cast<size_t>(Rules.MapWidth), static_cast<size_t>(Rules.MapHeight));
+        for (size_t i = 0; i < state.GiantsCount; ++i) {
+            const auto giant = state.GetGiantPosition(i);
+            dangers.SetSquare(giant.X, giant.Y, 1);
+        }
+        for (const auto& dir : GetPossibleDirections()) {
+            const auto next = state.GetThorPosition() + dir;
+            if (WorldMap.IsOnMap(next) && !dangers.Get(static_cast<size_t>(next.X), static_cast<size_t>(next.Y))) {
+                value += SAFE_MOVE_VALUE;
+            }
+        }
+        return value;
     }
 };
 
-std::unique_ptr<IStrategy> CreateMainStrategy(const GameWorldMap& worldMap, const Giant::ListType& giants, Thor& thor) {
-    return std::make_unique<FollowMostDistant>(worldMap, giants, thor);
-}
+// In the order of AnyStrategy's alternatives
+enum class StrategyType {
+    FOLLOW_MOST_DISTANT,
+    LOOKAHEAD_SEARCH
+};
+
+// Lets the benchmarks set the strategy and its distance search per run, within one build
+class AnyStrategy final : public StrategyVariant<StrategyType, FollowMostDistant, LookaheadSearch> {
+public:
+    AnyStrategy(const GameWorldMap& worldMap, const Giant::ListType& giants, Thor& thor,
+        StrategyType type = StrategyType::THOR_STRATEGY, DistanceSearchType distanceSearch = DistanceSearchType::DISTANCE_SEARCH)
+        : StrategyVariant(type, worldMap, giants, thor, distanceSearch)
+    {
+    }
+};
+
+using MainStrategy = AnyStrategy::StrategyOf<StrategyType::THOR_STRATEGY>;
 #pragma endregion
 
-class World {
+template <typename DecisionStrategy>
+class BasicWorld {
 public:
-    explicit World(std::istream& input)
+    // The arguments after the input go to the strategy, e.g. the StrategyType of AnyStrategy
+    template <typename... StrategyArgs>
+    explicit BasicWorld(InputReader& input, StrategyArgs&&... strategyArgs)
         : Player(ReadThor(input))
-        , Giants(ReadGiants(input))
+        , Giants()
         , WorldMap(MAX_MAP_X, MAX_MAP_Y)
-        , Strategy(CreateMainStrategy(WorldMap, Giants, Player))
+        , Strategy(WorldMap, Giants, Player, std::forward<StrategyArgs>(strategyArgs)...)
     {
     }
 
-    void NextStep(std::istream& input, std::ostream& output) {
+    // Zero lifts the limit, e.g. for the benchmark's reproducible runs
+    void SetTurnBudget(std::chrono::milliseconds budget) {
+        TurnBudget = budget;
+    }
+
+    // Every turn starts with reading its input, so the caller can stop between any two turns.
+    // The turn's time runs from the moment its input arrives, parsing included.
+    void NextStep(InputReader& input, OutputWriter& output) {
+        input.WaitForInput();
+        const auto deadline = Deadline::After(Deadline::Clock::now(), TurnBudget);
+        ReadTurn(input);
         FillWorldMap();
-        DumpWorldMap(std::cerr);
-        output << Strategy->MakeDecision() << std::endl;
+        #if TRACE_LEVEL >= TRACE_LEVEL_MAP
+        DumpWorldMap(DebugOutput());
+        #endif
+        output << Strategy.MakeDecision(deadline);
+        output.EndTurn();
+        #if TRACE_LEVEL > TRACE_LEVEL_OFF
+        GetDebugBuffer().DrainTo(std::cerr);
+        #endif
         ClearWorldMap();
-
-        Read<int>(input); // skip the remaining number of hammer strikes
-        Giants = ReadGiants(input);
     }
 
     bool IsRunning() const {
@@ -474,43 +1282,57 @@ public:
 
 private:
     static constexpr int THOR_STRIKE_RADIUS = 4;
-    static constexpr int MAX_MAP_X = 40;
-    static constexpr int MAX_MAP_Y = 18;
+    static constexpr int MAX_MAP_X = static_cast<int>(PUZZLE_MAP_WIDTH);
+    static constexpr int MAX_MAP_Y = static_cast<int>(PUZZLE_MAP_HEIGHT);
 
     Thor Player;
     Giant::ListType Giants;
     GameWorldMap WorldMap;
-    std::unique_ptr<IStrategy> Strategy;
+    Point ThorOnMap;
+    DecisionStrategy Strategy;
+    std::chrono::milliseconds TurnBudget{TURN_TIME_BUDGET_MS};
 
 private:
-    static Thor ReadThor(std::istream& input) {
+    static Thor ReadThor(InputReader& input) {
         const auto position = Point::FromStream(input);
-        const auto strikesLeft = Read<int>(input);
-        return {position, THOR_STRIKE_RADIUS, strikesLeft};
+        return {position, THOR_STRIKE_RADIUS, 0};
+    }
+
+    void ReadTurn(InputReader& input) {
+        Player.SetStrikes(Read<int>(input));
+        ReadGiants(input, Giants);
     }
 
-    static Giant::ListType ReadGiants(std::istream& input) {
+    // Refills the list in place so that its buffer is reused across turns
+    static void ReadGiants(InputReader& input, Giant::ListType& giants) {
         const int amount = Read<int>(input);
-        Giant::ListType result;
+        giants.Clear();
         for (int i = 0; i < amount; ++i) {
-            result.emplace_back(Point::FromStream(input));
+            giants.PushBack(Point::FromStream(input));
         }
-        return result;
     }
 
     void FillWorldMap() {
-        WorldMap.PlaceThor(Player.GetPosition());
+        INSTRUMENT_PHASE(Phase::FILL_WORLD_MAP);
+        ThorOnMap = Player.GetPosition();
+        WorldMap.PlaceThor(ThorOnMap);
         for (const auto& giant : Giants) {
             WorldMap.PlaceGiant(giant.GetPosition());
         }
     }
 
+    // Only the cells stamped by FillWorldMap are reset, so the cost depends on the number of giants
+    // rather than on the board area (Thor may have moved since, hence ThorOnMap)
     void ClearWorldMap() {
-        WorldMap.Clear();
+        INSTRUMENT_PHASE(Phase::CLEAR_WORLD_MAP);
+        WorldMap.Clear(ThorOnMap);
+        for (const auto& giant : Giants) {
+            WorldMap.Clear(giant.GetPosition());
+        }
+        WorldMap.ClearDangers();
     }
 
     void DumpWorldMap(std::ostream& os) const {
-        #ifdef PRINT_DEBUG_INFO
         static const auto renderEntity = [](const GameWorldMap::CellType& type) {
             switch (type) {
                 case GameWorldMap::CellType::EMPTY: return '.';
@@ -520,7 +1342,9 @@ private:
             }
         };
 
-        os << "*" << std::string(2 * MAX_MAP_X - 1, '-') << "*\n|";
+        static const std::string border(2 * MAX_MAP_X - 1, '-');
+
+        os << "*" << border << "*\n|";
         for (int y = 0; y < MAX_MAP_Y; ++y) {
             bool isNewRow = y != 0;
             for (int x = 0; x < MAX_MAP_X; ++x) {
@@ -532,21 +1356,40 @@ private:
                 os << renderEntity(entity) << "|";
             }
         }
-        os << "\n*" << std::string(2 * MAX_MAP_X - 1, '-') << "*" << std::endl;
-        #endif
+        os << "\n*" << border << "*\n";
     }
 };
 
+using World = BasicWorld<MainStrategy>;
+
+#ifndef SOLUTION_NO_MAIN
+// Whatever is left of the trace and the counters, once the game has ended either way
+void DumpDiagnostics() {
+    GetDebugBuffer().DrainTo(std::cerr);
+    #if INSTRUMENTATION
+    Instrumentation<Phase>::Get().Dump(std::cerr);
+    #endif
+}
+
 int main(int argc, const char** argv) {
     try {
-        World world(std::cin);
-        while (world.IsRunning()) {
-            world.NextStep(std::cin, std::cout);
+        std::ios::sync_with_stdio(false);
+        // `power_of_thor_ep_2.bin game.trace` records the game for replay.cpp
+        TraceRecorder streams(std::cin, std::cout, argc > 1 ? argv[1] : nullptr);
+        InputReader input(streams.GetInput());
+        OutputWriter output(streams.GetOutput());
+        World world(input);
+        // The referee closes the input once the game is over
+        while (world.IsRunning() && input.HasMoreInput()) {
+            world.NextStep(input, output);
         }
     } catch (const std::exception& exception) {
+        DumpDiagnostics();
         std::cerr << "An error occurred: " << exception.what() << std::endl;
         return 1;
     }
 
+    DumpDiagnostics();
     return 0;
 }
+#endif
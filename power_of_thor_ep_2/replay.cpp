@@ -0,0 +1,20 @@
+// Replays a game recorded with `power_of_thor_ep_2.bin game.trace` through World at full speed,
+// reporting per-turn latency and every command which differs from the recorded one.
+//
+// Usage: power_of_thor_ep_2_replay.bin <trace file> [repeats]
+
+#define SOLUTION_NO_MAIN
+#include "power_of_thor_ep_2.cpp"
+
+#include "../common/benchmark.h"
+
+int main(int argc, const char** argv) {
+    try {
+        return RunReplay(argc, argv, "power_of_thor_ep_2",
+            [](InputReader& input) { return World(input); },
+            [](World& world, InputReader& input, OutputWriter& output) { world.NextStep(input, output); });
+    } catch (const std::exception& exception) {
+        std::cerr << "An error occurred: " << exception.what() << std::endl;
+        return 1;
+    }
+}
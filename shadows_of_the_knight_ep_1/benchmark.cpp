@@ -0,0 +1,108 @@
+// Offline referee for Shadows of the Knight ep. 1: generates buildings and bomb placements from a seed
+// and plays them in-process against Game, reporting per-turn latency, throughput and win rate.
+//
+// Usage: shadows_of_the_knight_ep_1_benchmark.bin [games] [seed] [threads] [max building size]
+
+#define SOLUTION_NO_MAIN
+#include "shadows_of_the_knight_ep_1.cpp"
+
+#include "../common/benchmark.h"
+
+#include <random>
+
+namespace {
+
+struct Window {
+    Coordinate X = 0;
+    Coordinate Y = 0;
+};
+
+struct Scenario {
+    Coordinate Width;
+    Coordinate Height;
+    int Turns;
+    Window Bomb;
+    Window Start;
+};
+
+// The bit width of value - 1: doubling a Coordinate up to the value would overflow past 2^62
+int CeilLog2(Coordinate value) {
+    int result = 0;
+    for (auto rest = value > 1 ? static_cast<unsigned long long>(value - 1) : 0ULL; rest != 0; rest >>= 1) {
+        ++result;
+    }
+    return result;
+}
+
+Scenario GenerateScenario(std::mt19937& random, Coordinate maxSize) {
+    Scenario scenario;
+    scenario.Width = std::uniform_int_distribution<Coordinate>(1, maxSize)(random);
+    scenario.Height = std::uniform_int_distribution<Coordinate>(1, maxSize)(random);
+    // Both axes are bisected at the same time, so the longest one decides how many jumps are needed
+    scenario.Turns = CeilLog2(std::max(scenario.Width, scenario.Height)) + 1;
+
+    std::uniform_int_distribution<Coordinate> xs(0, scenario.Width - 1);
+    std::uniform_int_distribution<Coordinate> ys(0, scenario.Height - 1);
+    scenario.Bomb = {xs(random), ys(random)};
+    scenario.Start = {xs(random), ys(random)};
+    return scenario;
+}
+
+std::string GetBombDirection(const Window& batman, const Window& bomb) {
+    std::string result;
+    if (bomb.Y != batman.Y) {
+        result += bomb.Y < batman.Y ? 'U' : 'D';
+    }
+    if (bomb.X != batman.X) {
+        result += bomb.X < batman.X ? 'L' : 'R';
+    }
+    return result;
+}
+
+bool PlayGame(const Scenario& scenario, BenchmarkStats& stats) {
+    MemoryChannel toSolution;
+    MemoryChannel toReferee;
+    std::iostream input(&toSolution);
+    std::iostream output(&toReferee);
+    input << scenario.Width << ' ' << scenario.Height << '\n'
+        << scenario.Turns << '\n'
+        << scenario.Start.X << ' ' << scenario.Start.Y << '\n';
+    InputReader reader(input);
+    OutputWriter writer(output);
+    Game game(reader);
+
+    Window batman = scenario.Start;
+    for (int turn = 0; turn < scenario.Turns; ++turn) {
+        if (batman.X == scenario.Bomb.X && batman.Y == scenario.Bomb.Y) {
+            return true;
+        }
+        input << GetBombDirection(batman, scenario.Bomb) << '\n';
+
+        stats.AddTurn(MeasureCall([&] {
+            game.DoStep(reader, writer);
+        }));
+
+        output >> batman.X >> batman.Y;
+        if (batman.X < 0 || batman.X >= scenario.Width || batman.Y < 0 || batman.Y >= scenario.Height) {
+            return false;
+        }
+    }
+    return batman.X == scenario.Bomb.X && batman.Y == scenario.Bomb.Y;
+}
+
+} // namespace
+
+int main(int argc, const char** argv) {
+    const auto games = GetArgument(argc, argv, 1, 10000);
+    const auto seed = GetArgument(argc, argv, 2, 42);
+    const auto threads = static_cast<size_t>(GetArgument(argc, argv, 3, 1));
+    const auto maxSize = static_cast<Coordinate>(GetArgument(argc, argv, 4, 10000));
+
+    auto stats = RunGames(games, threads, [&](uint64_t game, BenchmarkStats& gameStats) {
+        auto random = MakeGameRandom(seed, game);
+        return PlayGame(GenerateScenario(random, maxSize), gameStats);
+    });
+    stats.Report(std::cout, "shadows_of_the_knight_ep_1");
+
+    return 0;
+}
@@ -1,83 +1,83 @@
 #include <algorithm>
+#include <array>
 #include <iostream>
-#include <sstream>
+#include <stdexcept>
 #include <string>
-#include <utility>
-
-struct Point {
-    int X = 0;
-    int Y = 0;
+#include <string_view>
+
+#include "../common/hyper_rectangle.h"
+#include "../common/input_reader.h"
+#include "../common/output_writer.h"
+#include "../common/trace.h"
+
+// Buildings of the scaled-up scenarios have billions of windows per axis
+using Coordinate = long long;
+using BombArea = HyperRectangle<Coordinate, 2>;
+
+// Bomb direction letters as steps along the axes, so U/UR/R/DR/D/DL/L/UL map to bound updates
+// through a table indexed by the bits of their letters
+constexpr int UP = 1;
+constexpr int DOWN = 2;
+constexpr int LEFT = 4;
+constexpr int RIGHT = 8;
+
+struct DirectionStep {
+    bool IsValid;
+    BombArea::StepType Step;
 };
 
-class RectangularArea {
-public:
-    RectangularArea()
-        : Empty(true)
-    {}
-
-    RectangularArea(int topLeftX, int topLeftY, int bottomRightX, int bottomRightY)
-        : TopLeft{topLeftX, topLeftY}
-        , BottomRight{bottomRightX, bottomRightY}
-        , Empty(TopLeft.X > BottomRight.X || TopLeft.Y > BottomRight.Y)
-    {
-    }
-
-    bool IsEmpty() const { return Empty; }
-
-    Point GetMiddlePoint() const {
-        int w = BottomRight.X - TopLeft.X;
-        int h = BottomRight.Y - TopLeft.Y;
-        return {TopLeft.X + w / 2, TopLeft.Y + h / 2};
-    }
-
-    // Intersection
-    friend RectangularArea operator&(const RectangularArea& lhs, const RectangularArea& rhs) {
-        if (lhs.Empty || rhs.Empty) {
-            return { 0, 0, 0, 0 };
+constexpr DirectionStep NO_DIRECTION = {false, {0, 0}};
+
+constexpr std::array<DirectionStep, 16> DIRECTION_STEPS = {{
+    NO_DIRECTION,
+    {true, {0, -1}},  // U
+    {true, {0, 1}},   // D
+    NO_DIRECTION,
+    {true, {-1, 0}},  // L
+    {true, {-1, -1}}, // UL
+    {true, {-1, 1}},  // DL
+    NO_DIRECTION,
+    {true, {1, 0}},   // R
+    {true, {1, -1}},  // UR
+    {true, {1, 1}},   // DR
+    NO_DIRECTION,
+    NO_DIRECTION,
+    NO_DIRECTION,
+    NO_DIRECTION,
+    NO_DIRECTION
+}};
+
+inline const BombArea::StepType& GetDirectionStep(std::string_view direction) {
+    int bits = 0;
+    for (const char c : direction) {
+        const int bit = c == 'U' ? UP : c == 'D' ? DOWN : c == 'L' ? LEFT : c == 'R' ? RIGHT : 0;
+        if (bit == 0 || (bits & bit) != 0) {
+            bits = 0;
+            break;
         }
-
-        int newTopLeftX = std::max(lhs.TopLeft.X, rhs.TopLeft.X);
-        int newTopLeftY = std::max(lhs.TopLeft.Y, rhs.TopLeft.Y);
-        int newBottomRightX = std::min(lhs.BottomRight.X, rhs.BottomRight.X);
-        int newBottomRightY = std::min(lhs.BottomRight.Y, rhs.BottomRight.Y);
-
-        return {newTopLeftX, newTopLeftY, newBottomRightX, newBottomRightY};
+        bits |= bit;
     }
 
-    // Union
-    friend RectangularArea operator|(const RectangularArea& lhs, const RectangularArea& rhs) {
-        if (lhs.Empty) {
-            return rhs;
-        } else if (rhs.Empty) {
-            return lhs;
-        }
-
-        int newTopLeftX = std::min(lhs.TopLeft.X, rhs.TopLeft.X);
-        int newTopLeftY = std::min(lhs.TopLeft.Y, rhs.TopLeft.Y);
-        int newBottomRightX = std::max(lhs.BottomRight.X, rhs.BottomRight.X);
-        int newBottomRightY = std::max(lhs.BottomRight.Y, rhs.BottomRight.Y);
-
-        return { newTopLeftX, newTopLeftY, newBottomRightX, newBottomRightY };
+    const auto& entry = DIRECTION_STEPS[static_cast<size_t>(bits)];
+    if (!entry.IsValid) {
+        throw std::runtime_error("Wrong bomb direction: " + std::string(direction));
     }
-
-private:
-    Point TopLeft;
-    Point BottomRight;
-    bool Empty;
-};
+    return entry.Step;
+}
 
 struct Building {
-    explicit Building(std::istream& is) {
-        is >> Width >> Height;
+    explicit Building(InputReader& is) {
+        Width = is.ReadInteger();
+        Height = is.ReadInteger();
     };
 
-    int Width;
-    int Height;
+    Coordinate Width;
+    Coordinate Height;
 };
 
 struct GameData {
-    explicit GameData(std::istream& is) {
-        is >> MaxTurns;
+    explicit GameData(InputReader& is) {
+        MaxTurns = static_cast<int>(is.ReadInteger());
     }
 
     int MaxTurns;
@@ -85,87 +85,77 @@ struct GameData {
 
 class Batman {
 public:
-    explicit Batman(std::istream& is, const Building& house)
-        : House(house)
-    {
-        is >> X >> Y;
+    explicit Batman(InputReader& is) {
+        const Coordinate x = is.ReadInteger();
+        const Coordinate y = is.ReadInteger();
+        Position = {x, y};
     }
 
-    int GetX() const { return X; }
-    int GetY() const { return Y; }
+    Coordinate GetX() const { return Position[0]; }
+    Coordinate GetY() const { return Position[1]; }
 
-    void JumpTo(const Point& location) {
-        X = location.X;
-        Y = location.Y;
-    }
+    const BombArea::PointType& GetPosition() const { return Position; }
 
-    RectangularArea DecidePossibleArea(char dir) const {
-        switch (dir) {
-            case 'U':
-                return { X, -1, X, Y };
-            case 'D':
-                return { X, Y, X, House.Height };
-            case 'L':
-                return { -1, Y, X, Y };
-            case 'R':
-                return { X, Y, House.Width, Y };
-            default:
-                std::cerr << "Wrong bomb direction: " << dir << std::endl;
-                return { -1, -1, -1, -1 };
-        }
+    void JumpTo(const BombArea::PointType& location) {
+        Position = location;
     }
-    
+
 private:
-    const Building& House;
-    int X;
-    int Y;
+    BombArea::PointType Position;
 };
 
 class Game {
 public:
-    Game(std::istream& is)
+    Game(InputReader& is)
         : House(is)
         , Data(is)
-        , Player(is, House)
-        , PossibleArea(0, 0, House.Width, House.Height)
+        , Player(is)
+        , PossibleArea({0, 0}, {House.Width - 1, House.Height - 1})
     {}
         
-    std::string DoStep(std::istream& is) {
-        std::string bombDir;
-        is >> bombDir;
-        RunLogic(bombDir);
-        return RenderOutput();
+    void DoStep(InputReader& is, OutputWriter& os) {
+        is.ReadWord(BombDir);
+        RunLogic(BombDir);
+        RenderOutput(os);
     }
 
 private:
     const Building House;
     const GameData Data;
     Batman Player;
-    RectangularArea PossibleArea;
+    BombArea PossibleArea;
+    std::string BombDir;
     
     void RunLogic(const std::string& bombDir) {
-        RectangularArea newBombArea;
-
-        for (char dir : bombDir) {
-            auto newArea = Player.DecidePossibleArea(dir);
-            newBombArea = newBombArea | newArea;
-        }
-
-        PossibleArea = PossibleArea & newBombArea;
+        PossibleArea.Narrow(Player.GetPosition(), GetDirectionStep(bombDir));
         Player.JumpTo(PossibleArea.GetMiddlePoint());
     }
     
-    std::string RenderOutput() const {
-        std::stringstream out;
-        out << Player.GetX() << ' ' << Player.GetY();
-        return out.str();
+    void RenderOutput(OutputWriter& os) const {
+        os << Player.GetX() << " " << Player.GetY();
+        os.EndTurn();
     }
 };
 
-int main()
+#ifndef SOLUTION_NO_MAIN
+int main(int argc, const char** argv)
 {
-    Game game(std::cin);
-    while (true) {
-        std::cout << game.DoStep(std::cin) << std::endl;
+    try {
+        std::ios::sync_with_stdio(false);
+        // `shadows_of_the_knight_ep_1.bin game.trace` records the game for replay.cpp
+        TraceRecorder streams(std::cin, std::cout, argc > 1 ? argv[1] : nullptr);
+        InputReader input(streams.GetInput());
+        OutputWriter output(streams.GetOutput());
+        Game game(input);
+        // The referee closes the input once the bomb is found
+        while (input.HasMoreInput()) {
+            game.DoStep(input, output);
+        }
+    } catch (const std::exception& exception) {
+        std::cerr << "An error occurred: " << exception.what() << std::endl;
+        return 1;
     }
+
+    return 0;
 }
+#endif
@@ -0,0 +1,114 @@
+// Offline referee for Shadows of the Knight ep. 2: generates buildings and bomb placements from a seed
+// and plays them in-process against Game, reporting per-turn latency, throughput and win rate.
+//
+// Usage: shadows_of_the_knight_ep_2_benchmark.bin [games] [seed] [threads] [strategy]
+// where the strategy is a StrategyType index: 0 - BISECTION, 1 - SYMMETRIC_PROBE
+
+#define SOLUTION_NO_MAIN
+#include "shadows_of_the_knight_ep_2.cpp"
+
+#include "../common/benchmark.h"
+
+#include <random>
+
+namespace {
+
+struct Scenario {
+    int Width;
+    int Height;
+    int Turns;
+    Point Bomb;
+    Point Start;
+};
+
+int CeilLog2(int value) {
+    int result = 0;
+    while ((1 << result) < value) {
+        ++result;
+    }
+    return result;
+}
+
+Scenario GenerateScenario(std::mt19937& random) {
+    Scenario scenario;
+    scenario.Width = std::uniform_int_distribution<int>(Building::MIN_WIDTH, Building::MAX_WIDTH)(random);
+    scenario.Height = std::uniform_int_distribution<int>(Building::MIN_HEIGHT, Building::MAX_HEIGHT)(random);
+    // Every axis is bisected separately and the feedback is only relative, so leave a few spare jumps
+    scenario.Turns = std::min(CeilLog2(scenario.Width) + CeilLog2(scenario.Height) + 4, 100);
+
+    std::uniform_int_distribution<int> xs(0, scenario.Width - 1);
+    std::uniform_int_distribution<int> ys(0, scenario.Height - 1);
+    scenario.Bomb = {xs(random), ys(random)};
+    do {
+        scenario.Start = {xs(random), ys(random)};
+    } while (scenario.Start.X == scenario.Bomb.X && scenario.Start.Y == scenario.Bomb.Y);
+    return scenario;
+}
+
+long long SquaredDistance(const Point& lhs, const Point& rhs) {
+    const long long dx = lhs.X - rhs.X;
+    const long long dy = lhs.Y - rhs.Y;
+    return dx * dx + dy * dy;
+}
+
+const char* GetFeedback(const Point& previous, const Point& current, const Point& bomb) {
+    const auto before = SquaredDistance(previous, bomb);
+    const auto after = SquaredDistance(current, bomb);
+    if (after < before) {
+        return "WARMER";
+    }
+    return after > before ? "COLDER" : "SAME";
+}
+
+bool PlayGame(const Scenario& scenario, StrategyType strategy, BenchmarkStats& stats) {
+    MemoryChannel toSolution;
+    MemoryChannel toReferee;
+    std::iostream input(&toSolution);
+    std::iostream output(&toReferee);
+    input << scenario.Width << ' ' << scenario.Height << '\n'
+        << scenario.Turns << '\n'
+        << scenario.Start.X << ' ' << scenario.Start.Y << '\n';
+    InputReader reader(input);
+    OutputWriter writer(output);
+
+    try {
+        BasicGame<AnyStrategy> game(reader, strategy);
+        Point previous = scenario.Start;
+        Point batman = scenario.Start;
+        for (int turn = 0; turn < scenario.Turns && game.IsRunning(); ++turn) {
+            input << (turn == 0 ? "UNKNOWN" : GetFeedback(previous, batman, scenario.Bomb)) << '\n';
+            stats.AddTurn(MeasureCall([&] {
+                game.NextTurn(reader, writer);
+            }));
+
+            previous = batman;
+            output >> batman.X >> batman.Y;
+            if (batman.X < 0 || batman.X >= scenario.Width || batman.Y < 0 || batman.Y >= scenario.Height) {
+                return false;
+            }
+            if (batman.X == scenario.Bomb.X && batman.Y == scenario.Bomb.Y) {
+                return true;
+            }
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return false;
+}
+
+} // namespace
+
+int main(int argc, const char** argv) {
+    const auto games = GetArgument(argc, argv, 1, 10000);
+    const auto seed = GetArgument(argc, argv, 2, 42);
+    const auto threads = static_cast<size_t>(GetArgument(argc, argv, 3, 1));
+    const auto strategy = static_cast<StrategyType>(GetArgument(argc, argv, 4, static_cast<uint64_t>(StrategyType::SHADOWS_STRATEGY)));
+
+    auto stats = RunGames(games, threads, [&](uint64_t game, BenchmarkStats& gameStats) {
+        auto random = MakeGameRandom(seed, game);
+        return PlayGame(GenerateScenario(random), strategy, gameStats);
+    });
+    stats.Report(std::cout, "shadows_of_the_knight_ep_2");
+
+    return 0;
+}
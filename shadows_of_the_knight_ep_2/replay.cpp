@@ -0,0 +1,20 @@
+// Replays a game recorded with `shadows_of_the_knight_ep_2.bin game.trace` through Game at full speed,
+// reporting per-turn latency and every jump which differs from the recorded one.
+//
+// Usage: shadows_of_the_knight_ep_2_replay.bin <trace file> [repeats]
+
+#define SOLUTION_NO_MAIN
+#include "shadows_of_the_knight_ep_2.cpp"
+
+#include "../common/benchmark.h"
+
+int main(int argc, const char** argv) {
+    try {
+        return RunReplay(argc, argv, "shadows_of_the_knight_ep_2",
+            [](InputReader& input) { return Game(input); },
+            [](Game& game, InputReader& input, OutputWriter& output) { game.NextTurn(input, output); });
+    } catch (const std::exception& exception) {
+        std::cerr << "An error occurred: " << exception.what() << std::endl;
+        return 1;
+    }
+}
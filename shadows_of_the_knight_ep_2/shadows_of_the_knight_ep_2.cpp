@@ -1,46 +1,44 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <exception>
 #include <iostream>
-#include <memory>
-#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <utility>
 
-#define IS_DEBUG
+// 0 - no tracing, 1 - decisions; set it with `make TRACE_LEVEL=...`
+#define TRACE_LEVEL_OFF 0
+#define TRACE_LEVEL_DECISIONS 1
 
-#pragma region("COMMON TYPES")
-using String = std::string;
+#ifndef TRACE_LEVEL
+#define TRACE_LEVEL TRACE_LEVEL_OFF
+#endif
 
-template <typename T>
-using Holder = std::unique_ptr<T>;
+// The strategy Game plays with, see StrategyType; set it with `make SHADOWS_STRATEGY=...`
+#ifndef SHADOWS_STRATEGY
+#define SHADOWS_STRATEGY SYMMETRIC_PROBE
+#endif
 
-template <typename T, typename... Args>
-Holder<T> MakeHolder(Args... args) {
-    return std::make_unique<T>(std::forward<Args>(args)...);
-}
+#pragma region("COMMON TYPES")
+using String = std::string;
 #pragma endregion
 
 #pragma region("INPUT UTILS")
-template <typename T>
-T Read(std::istream& input) {
-    T result;
-    input >> result;
-    return result;
-}
+#include "../common/input_reader.h"
+#include "../common/check_argument.h"
+#pragma endregion
 
-template <typename T, typename PredicateType>
-T CheckArgument(const T& argument, const PredicateType& pred, const String& message = "") {
-    if (!pred(argument)) {
-        std::stringstream formattedMessage;
-        if (!message.empty()) {
-            formattedMessage << message << ": ";
-        }
-        formattedMessage << "argument '" << argument << "' is incorrect";
-        throw std::runtime_error(formattedMessage.str());
-    }
-    return argument;
-}
+#pragma region("OUTPUT UTILS")
+#include "../common/output_writer.h"
+#include "../common/debug_output.h"
+#include "../common/trace.h"
 #pragma endregion
 
 #pragma region("MATH UTILS")
+#include "../common/hyper_rectangle.h"
+
 struct Point {
     int X = 0;
     int Y = 0;
@@ -50,7 +48,7 @@ struct Point {
 #pragma region("GAME ENTITIES")
 class Building final {
 public:
-    Building(int width, int height) noexcept
+    Building(int width, int height)
         : Width(CheckArgument(width, [](int w) {
             return w >= MIN_WIDTH && w <= MAX_WIDTH;
         }, "Building width"))
@@ -81,7 +79,7 @@ private:
 
 class Batman final {
 public:
-    Batman(int x, int y) noexcept
+    Batman(int x, int y)
         : Position{
             CheckArgument(x, [](int x0) {
                 return x0 >= 0 && x0 < Building::MAX_WIDTH;
@@ -103,32 +101,244 @@ private:
 #pragma endregion
 
 #pragma region("STRATEGY")
-class IStrategy {
+#include "../common/strategy_variant.h"
+
+// Every strategy is built from the building and Batman's start, and answers a turn with
+// `Point MakeDecision(const String& bombDirection)`. They track Batman's jumps themselves, Game only
+// passes the feedback on.
+
+// Candidates for one coordinate of the bomb, a one-dimensional HyperRectangle. A jump along the axis
+// cuts them in the middle between the previous and the current position, and the feedback tells which
+// side to keep. Unlike the first episode's box, a cut may miss every candidate left: the interval
+// collapses onto its low end then instead of going empty.
+class IntervalSearch final {
 public:
-    virtual ~IStrategy() = default;
+    explicit IntervalSearch(int size)
+        : Size(size)
+        , Candidates({0}, {size - 1})
+    {
+    }
+
+    bool IsDone() const {
+        return GetLow() >= GetHigh();
+    }
+
+    int GetFound() const {
+        return GetLow();
+    }
+
+    // previousOffset is how much farther from the bomb the previous position was along the other axes,
+    // zero unless the jump moved along them as well
+    void Cut(int previous, int current, const String& feedback, long long previousOffset = 0) {
+        // WARMER means (b - current)^2 < (b - previous)^2 + previousOffset, i.e. slope * b < threshold
+        long long slope = 2LL * (previous - current);
+        long long threshold = 1LL * (previous - current) * (previous + current) + previousOffset;
+        bool isBombBelow = feedback == "WARMER";
+        if (slope == 0) {
+            return;
+        }
+        if (slope < 0) {
+            slope = -slope;
+            threshold = -threshold;
+            isBombBelow = !isBombBelow;
+        }
+
+        if (feedback == "SAME") {
+            // The bomb is exactly on the cut, which is only possible when the cut is on a cell
+            if (threshold % slope == 0) {
+                Candidates.Pin(AXIS, static_cast<int>(threshold / slope));
+            }
+            return;
+        }
+        if (isBombBelow) {
+            Candidates.KeepAtMost(AXIS, static_cast<int>(std::min<long long>(GetHigh(), FloorDiv(threshold - 1, slope))));
+        } else {
+            Candidates.KeepAtLeast(AXIS, static_cast<int>(std::max<long long>(GetLow(), FloorDiv(threshold, slope) + 1)));
+        }
+        if (Candidates.IsEmpty()) {
+            Candidates.Pin(AXIS, GetLow());
+        }
+    }
+
+    // The mirror of the current position about the middle of the candidates, so that the next cut
+    // halves them. It's clamped to the building; the jump must move, or the feedback is meaningless.
+    int NextProbe(int current) const {
+        if (IsDone()) {
+            return GetLow();
+        }
+        const int probe = std::min(std::max(GetLow() + GetHigh() - current, 0), Size - 1);
+        if (probe != current) {
+            return probe;
+        }
+        return current + 1 < Size ? current + 1 : current - 1;
+    }
+
+    // A jump to a point exactly as far from the middle of the candidates as the current position, so
+    // that the middle is on the cut. currentOffset is the squared distance between the current position
+    // and the bomb along the other axes, when the jump also moves there to land on the found coordinates.
+    // For zero it's the mirror; when that's out of the building, a clamped jump which can't cut the
+    // candidates at all lands on their far end instead, from where the next mirror has room.
+    int NextSymmetricProbe(int current, long long currentOffset = 0) const {
+        if (IsDone()) {
+            return GetLow();
+        }
+
+        const double middle = (GetLow() + GetHigh()) / 2.0;
+        const double radius = std::sqrt((middle - current) * (middle - current) + static_cast<double>(currentOffset));
+        for (const double candidate : {middle + radius, middle - radius}) {
+            const auto probe = static_cast<int>(std::lround(candidate));
+            if (probe != current && probe >= 0 && probe < Size) {
+                return probe;
+            }
+        }
+
+        const int mirror = GetLow() + GetHigh() - current;
+        int probe = std::min(std::max(mirror, 0), Size - 1);
+        const int doubledCut = current + probe;
+        if (doubledCut < 2 * GetLow() || doubledCut > 2 * GetHigh()) {
+            probe = mirror < 0 ? GetHigh() : GetLow();
+        }
+        if (probe != current) {
+            return probe;
+        }
+        return current + 1 < Size ? current + 1 : current - 1;
+    }
+
+private:
+    static constexpr size_t AXIS = 0;
+
+    int Size;
+    HyperRectangle<int, 1> Candidates;
 
-    virtual Point MakeDecision(const String& bomdDirection) = 0;
+private:
+    int GetLow() const {
+        return Candidates.GetLow(AXIS);
+    }
+
+    int GetHigh() const {
+        return Candidates.GetHigh(AXIS);
+    }
+
+    static long long FloorDiv(long long numerator, long long denominator) {
+        return numerator >= 0 ? numerator / denominator : -((denominator - 1 - numerator) / denominator);
+    }
 };
 
-class SimpleStrategy final : public IStrategy {
+// Finds the bomb's x with the y fixed and then its y with the x found, every jump moving along a single
+// axis so that the feedback is a cut of a single interval. Each search takes about log2 of its size.
+class BisectionStrategy final {
 public:
-    Point MakeDecision(const String& /*bombDirection*/) override {
-        return {0, 0};
+    BisectionStrategy(const Building& house, const Point& start)
+        : Current(start)
+        , Previous(start)
+        , Xs(house.GetWidth())
+        , Ys(house.GetHeight())
+    {
     }
+
+    Point MakeDecision(const String& bombDirection) {
+        if (Previous.Y == Current.Y && Previous.X != Current.X) {
+            Xs.Cut(Previous.X, Current.X, bombDirection);
+        } else if (Previous.X == Current.X && Previous.Y != Current.Y) {
+            Ys.Cut(Previous.Y, Current.Y, bombDirection);
+        }
+
+        Point next = Current;
+        if (!Xs.IsDone()) {
+            next.X = Xs.NextProbe(Current.X);
+        } else if (Current.X != Xs.GetFound()) {
+            next.X = Xs.GetFound();
+        } else {
+            next.Y = Ys.NextProbe(Current.Y);
+        }
+
+        Previous = Current;
+        Current = next;
+        return next;
+    }
+
+private:
+    Point Current;
+    Point Previous;
+    IntervalSearch Xs;
+    IntervalSearch Ys;
 };
 
-Holder<IStrategy> CreateStrategy() {
-    return MakeHolder<SimpleStrategy>();
-}
+// Same axis by axis search as BisectionStrategy, with two turns saved here and there. Mirrors falling
+// out of the building don't waste jumps on cuts next to nothing, and the jump landing on the found x
+// already probes y: the x is known, so its feedback is still an exact cut of the y candidates.
+class SymmetricProbeStrategy final {
+public:
+    SymmetricProbeStrategy(const Building& house, const Point& start)
+        : Current(start)
+        , Previous(start)
+        , Xs(house.GetWidth())
+        , Ys(house.GetHeight())
+    {
+    }
+
+    Point MakeDecision(const String& bombDirection) {
+        if (Previous.Y == Current.Y && Previous.X != Current.X) {
+            Xs.Cut(Previous.X, Current.X, bombDirection);
+        } else if (Previous.Y != Current.Y && (Previous.X == Current.X || Xs.IsDone())) {
+            Ys.Cut(Previous.Y, Current.Y, bombDirection, GetSquaredOffset(Previous.X));
+        }
+
+        Point next = Current;
+        if (!Xs.IsDone()) {
+            next.X = Xs.NextSymmetricProbe(Current.X);
+        } else {
+            next.X = Xs.GetFound();
+            next.Y = Ys.NextSymmetricProbe(Current.Y, GetSquaredOffset(Current.X));
+        }
+
+        Previous = Current;
+        Current = next;
+        return next;
+    }
+
+private:
+    Point Current;
+    Point Previous;
+    IntervalSearch Xs;
+    IntervalSearch Ys;
+
+private:
+    // Squared distance to the bomb along x, once it's found
+    long long GetSquaredOffset(int x) const {
+        const long long dx = x - Xs.GetFound();
+        return dx * dx;
+    }
+};
+
+// In the order of AnyStrategy's alternatives
+enum class StrategyType {
+    BISECTION,
+    SYMMETRIC_PROBE
+};
+
+// For the benchmark, which compares both searches on the same buildings within one build
+class AnyStrategy final : public StrategyVariant<StrategyType, BisectionStrategy, SymmetricProbeStrategy> {
+public:
+    AnyStrategy(const Building& house, const Point& start, StrategyType type = StrategyType::SHADOWS_STRATEGY)
+        : StrategyVariant(type, house, start)
+    {
+    }
+};
+
+using MainStrategy = AnyStrategy::StrategyOf<StrategyType::SHADOWS_STRATEGY>;
 #pragma endregion
 
-class Game final {
+template <typename DecisionStrategy>
+class BasicGame final {
 public:
-    explicit Game(std::istream& input) noexcept
+    // The arguments after the input go to the strategy, e.g. the StrategyType of AnyStrategy
+    template <typename... StrategyArgs>
+    explicit BasicGame(InputReader& input, StrategyArgs&&... strategyArgs)
         : House(ReadBuilding(input))
         , TurnsLeft(ReadTurns(input))
         , Player(ReadBatman(input))
-        , Strategy(CreateStrategy())
+        , Strategy(House, Player.GetPosition(), std::forward<StrategyArgs>(strategyArgs)...)
     {
     }
 
@@ -136,7 +346,7 @@ public:
         return TurnsLeft >= STOP_BELOW_TURNS;
     }
 
-    void NextTurn(std::istream& input, std::ostream& output) {
+    void NextTurn(InputReader& input, OutputWriter& output) {
         BeforeTurn();
         OnTurn(input, output);
         AfterTurn();
@@ -150,23 +360,24 @@ private:
     Building House;
     int TurnsLeft;
     Batman Player;
-    Holder<IStrategy> Strategy;
+    DecisionStrategy Strategy;
+    String BombDir; // kept between turns to reuse its buffer
 
 private:
-    static Building ReadBuilding(std::istream& input) {
+    static Building ReadBuilding(InputReader& input) {
         int w = Read<int>(input);
         int h = Read<int>(input);
         return {w, h};
     }
 
-    static int ReadTurns(std::istream& input) {
+    static int ReadTurns(InputReader& input) {
         int turnsLeft = Read<int>(input);
         return CheckArgument(turnsLeft, [](int turns) {
             return turns >= MIN_INPUT_TURNS && turns <= MAX_INPUT_TURNS;
         }, "Turns left");
     }
 
-    static Batman ReadBatman(std::istream& input) {
+    static Batman ReadBatman(InputReader& input) {
         int x = Read<int>(input);
         int y = Read<int>(input);
         return {x, y};
@@ -178,11 +389,17 @@ private:
         }
     }
 
-    void OnTurn(std::istream& input, std::ostream& output) {
-        String bombDir;
-        input >> bombDir;
-        const auto jumpTo = Strategy->MakeDecision(bombDir);
-        output << jumpTo.X << " " << jumpTo.Y << std::endl;
+    void OnTurn(InputReader& input, OutputWriter& output) {
+        input.ReadWord(BombDir);
+        const auto jumpTo = Strategy.MakeDecision(BombDir);
+        #if TRACE_LEVEL >= TRACE_LEVEL_DECISIONS
+        DebugOutput() << "Bomb direction: " << BombDir << "; jump to: " << jumpTo.X << " " << jumpTo.Y << '\n';
+        #endif
+        output << jumpTo.X << " " << jumpTo.Y;
+        output.EndTurn();
+        #if TRACE_LEVEL > TRACE_LEVEL_OFF
+        GetDebugBuffer().DrainTo(std::cerr);
+        #endif
     }
 
     void AfterTurn() {
@@ -190,12 +407,28 @@ private:
     }
 };
 
+using Game = BasicGame<MainStrategy>;
+
+#ifndef SOLUTION_NO_MAIN
 int main(int argc, const char** argv)
 {
-    Game game(std::cin);
-    while (game.IsRunning()) {
-        game.NextTurn(std::cin, std::cout);
+    try {
+        std::ios::sync_with_stdio(false);
+        // `shadows_of_the_knight_ep_2.bin game.trace` records the game for replay.cpp
+        TraceRecorder streams(std::cin, std::cout, argc > 1 ? argv[1] : nullptr);
+        InputReader input(streams.GetInput());
+        OutputWriter output(streams.GetOutput());
+        Game game(input);
+        // The referee closes the input once the bomb is found
+        while (game.IsRunning() && input.HasMoreInput()) {
+            game.NextTurn(input, output);
+        }
+    } catch (const std::exception& exception) {
+        GetDebugBuffer().DrainTo(std::cerr);
+        std::cerr << "An error occurred: " << exception.what() << std::endl;
+        return 1;
     }
 
     return 0;
 }
+#endif
@@ -0,0 +1,46 @@
+#!/usr/bin/env python3
+"""Inlines the local headers of a solution, so that it becomes the single file CodinGame accepts.
+
+Usage: amalgamate.py <solution.cpp> <submission.cpp>
+
+Every `#include "..."` is replaced by the header it names, recursively and only once per header,
+the way `#pragma once` would include it. System includes are kept where they are.
+"""
+
+import os
+import re
+import sys
+
+LOCAL_INCLUDE = re.compile(r'^\s*#\s*include\s+"([^"]+)"\s*$')
+PRAGMA_ONCE = re.compile(r'^\s*#\s*pragma\s+once\s*$')
+
+
+def inline(path, included, output):
+    path = os.path.realpath(path)
+    if path in included:
+        return
+    included.add(path)
+
+    with open(path) as source:
+        for line in source:
+            if PRAGMA_ONCE.match(line):
+                continue
+            match = LOCAL_INCLUDE.match(line)
+            if match:
+                inline(os.path.join(os.path.dirname(path), match.group(1)), included, output)
+            else:
+                output.append(line)
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__.strip().splitlines()[2])
+
+    lines = []
+    inline(sys.argv[1], set(), lines)
+    with open(sys.argv[2], 'w') as submission:
+        submission.writelines(lines)
+
+
+if __name__ == '__main__':
+    main()
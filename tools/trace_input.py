@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+"""Prints the referee's input recorded in a trace, as the solution read it.
+
+Usage: trace_input.py <trace file>
+
+The format is described in common/trace.h. Piping the output into a solution plays the recorded
+game again without a referee, e.g. to train a profile-guided build on it.
+"""
+
+import sys
+
+INPUT_RECORD = 0
+
+
+def read_varint(data, position):
+    result = 0
+    shift = 0
+    while True:
+        if position == len(data):
+            raise ValueError('The trace ends inside a varint')
+        byte = data[position]
+        position += 1
+        result |= (byte & 0x7F) << shift
+        if byte & 0x80 == 0:
+            return result, position
+        shift += 7
+
+
+def zigzag_decode(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def decode_input_line(payload):
+    tokens = []
+    position = 0
+    while position < len(payload):
+        token, position = read_varint(payload, position)
+        if token & 1 == 0:
+            tokens.append(str(zigzag_decode(token >> 1)))
+            continue
+        length = token >> 1
+        if length > len(payload) - position:
+            raise ValueError('The trace ends inside a word')
+        tokens.append(payload[position:position + length].decode())
+        position += length
+    return ' '.join(tokens)
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__.strip().splitlines()[2])
+
+    with open(sys.argv[1], 'rb') as trace:
+        data = trace.read()
+
+    position = 0
+    while position < len(data):
+        header, position = read_varint(data, position)
+        size = header >> 1
+        if size > len(data) - position:
+            raise ValueError('The trace ends inside a record')
+        if header & 1 == INPUT_RECORD:
+            print(decode_input_line(data[position:position + size]))
+        position += size
+
+
+if __name__ == '__main__':
+    main()